@@ -0,0 +1,325 @@
+#include "BoilerControl.h"
+
+const char *stopReasonName(StopReason reason)
+{
+    switch (reason)
+    {
+    case StopReason::TargetReached:
+        return "target";
+    case StopReason::EarlyStop:
+        return "early";
+    case StopReason::TimerExpired:
+        return "timer";
+    case StopReason::Cancelled:
+        return "cancelled";
+    case StopReason::Disabled:
+        return "disabled";
+    default:
+        return "none";
+    }
+}
+
+BoilerController::BoilerController(BoilerRelay &relay, BoilerClock &clock, BoilerEvents &events)
+    : relay_(relay), clock_(clock), events_(events)
+{
+}
+
+void BoilerController::tick(bool forceOn)
+{
+    const uint32_t now = clock_.millis();
+    if (!checked_)
+    {
+        checked_ = true;
+        lastCheckMs_ = now;
+    }
+    else if (now - lastCheckMs_ < CHECK_INTERVAL_MS)
+    {
+        return;
+    }
+    else
+    {
+        // Anchor to the previous check so call jitter does not stretch the countdown.
+        lastCheckMs_ = (now - lastCheckMs_ < 2 * CHECK_INTERVAL_MS) ? lastCheckMs_ + CHECK_INTERVAL_MS : now;
+    }
+
+    const int prevTime = timeRemainingSec_;
+    forceOn = forceOn || forcePending_;
+    forcePending_ = false;
+
+    // When we force-enable the boiler (e.g. due to under-temperature alarm),
+    // ensure we actually have a non-zero timer so the control logic below can turn the relay on.
+    if (forceOn && timeRemainingSec_ <= 0)
+    {
+        int mins = config_.boilerTimeMin;
+        if (mins <= 0)
+        {
+            mins = 1;
+        }
+        timeRemainingSec_ = mins * 60;
+        events_.onForcedHeatingStart(mins);
+    }
+
+    // Predictive stop: the residual heat after the burner stops carries the tank to the target.
+    if (config_.earlyStop && !forceOn && !alarmActive_ && stopMarginC_ > 0.0f && relay_.get() && timeRemainingSec_ > 0 &&
+        temperature_ < config_.offThreshold && temperature_ + stopMarginC_ >= config_.offThreshold &&
+        stopRelay(StopReason::EarlyStop))
+    {
+        timeRemainingSec_ = 0;
+        earlyStops_++;
+        events_.onEarlyStop(temperature_, stopMarginC_);
+        clearWillShower();
+    }
+
+    // Temperature-based auto control: turn off when upper threshold reached, allow turn-on when below lower threshold
+    if (relay_.get())
+    {
+        if (temperature_ >= config_.offThreshold)
+        {
+            stopRelay(StopReason::TargetReached, temperature_ >= config_.offThreshold + MAX_DWELL_OVERSHOOT_C);
+            if (config_.stopTimerOnTarget)
+            {
+                timeRemainingSec_ = 0;
+                clearWillShower();
+            }
+        }
+    }
+    else
+    {
+        if ((config_.enabled || forceOn) && (temperature_ <= config_.onThreshold) && (timeRemainingSec_ > 0))
+        {
+            switchRelay(true);
+        }
+    }
+
+    if (config_.enabled || forceOn)
+    {
+        if (timeRemainingSec_ > 0)
+        {
+            switchRelay(true);
+            timeRemainingSec_--; // count down in seconds
+        }
+        else
+        {
+            stopRelay(StopReason::TimerExpired);
+        }
+    }
+    else
+    {
+        stopRelay(StopReason::Disabled, true); // turn off the boiler if disabled
+    }
+
+    // Detect timer end transition to 0 -> clear WillShower
+    if (prevTime > 0 && timeRemainingSec_ <= 0)
+    {
+        clearWillShower();
+        stopRelay(StopReason::TimerExpired);
+    }
+}
+
+void BoilerController::updateAlarm()
+{
+    const bool previousState = alarmActive_;
+
+    if (alarmActive_)
+    {
+        if (temperature_ >= config_.onThreshold + ALARM_HYSTERESIS_C)
+        {
+            alarmActive_ = false;
+        }
+    }
+    else if (temperature_ <= config_.onThreshold)
+    {
+        alarmActive_ = true;
+    }
+
+    if (alarmActive_ != previousState)
+    {
+        events_.onAlarmChanged(alarmActive_, temperature_);
+        forcePending_ = true; // force boiler if the temperature is too low
+        tick();               // now, unless the last step was less than CHECK_INTERVAL_MS ago
+    }
+}
+
+void BoilerController::startShowerTimer(int minutes)
+{
+    if (minutes <= 0)
+    {
+        return;
+    }
+    timeRemainingSec_ = minutes * 60;
+    willShowerRequested_ = true;
+    switchRelay(true); // if held back, tick() starts it once allowed
+}
+
+void BoilerController::setShowerRequest(bool requested)
+{
+    willShowerRequested_ = requested;
+    if (requested)
+    {
+        if (timeRemainingSec_ <= 0)
+        {
+            int mins = config_.boilerTimeMin;
+            if (mins <= 0)
+            {
+                mins = DEFAULT_SHOWER_MIN;
+            }
+            timeRemainingSec_ = mins * 60;
+        }
+        switchRelay(true);
+    }
+    else
+    {
+        // user canceled
+        timeRemainingSec_ = 0;
+        stopRelay(StopReason::Cancelled, true);
+    }
+}
+
+bool BoilerController::canShowerNow() const
+{
+    return (temperature_ >= config_.offThreshold) && relay_.get();
+}
+
+long BoilerController::currentPeriodId() const
+{
+    const long periodMin = config_.boilerTimeMin > 1 ? config_.boilerTimeMin : 1;
+    const long periodSec = periodMin * 60L;
+    const int64_t now = clock_.epochSeconds();
+    if (now > 24 * 60 * 60)
+    {
+        return static_cast<long>(now / periodSec);
+    }
+    return static_cast<long>((clock_.millis() / 1000UL) / periodSec);
+}
+
+BoilerController::ShowerNotice BoilerController::evaluateShowerNotice(bool retained)
+{
+    ShowerNotice notice;
+    const bool canShower = canShowerNow();
+
+    if (!config_.onlyOncePerPeriod)
+    {
+        notice.publish = true;
+        notice.value = canShower;
+        notice.retained = retained;
+        lastPublishedShower_ = canShower;
+        return notice;
+    }
+
+    if (canShower)
+    {
+        const long pid = currentPeriodId();
+        if (pid != lastShower1PeriodId_)
+        {
+            notice.publish = true;
+            notice.value = true;
+            notice.retained = true;
+            lastShower1PeriodId_ = pid;
+            lastPublishedShower_ = true;
+        }
+    }
+    else if (lastPublishedShower_)
+    {
+        notice.publish = true;
+        notice.value = false;
+        notice.retained = true;
+        lastPublishedShower_ = false;
+    }
+    return notice;
+}
+
+void BoilerController::resetShowerNotice()
+{
+    lastShower1PeriodId_ = -1;
+    lastPublishedShower_ = false;
+}
+
+bool BoilerController::switchRelay(bool on, bool exempt)
+{
+    if (relay_.get() == on)
+    {
+        return true;
+    }
+    const uint32_t now = clock_.millis();
+    if (!exempt)
+    {
+        const uint32_t dwellMs = static_cast<uint32_t>(on ? config_.minOffSec : config_.minOnSec) * 1000UL;
+        const int budget = config_.maxStartsPerHour < MAX_TRACKED_STARTS ? config_.maxStartsPerHour : MAX_TRACKED_STARTS;
+        const bool dwelling = switched_ && dwellMs > 0 && now - lastSwitchMs_ < dwellMs;
+        // An under-temperature alarm must not wait up to an hour for the budget; the dwell still applies
+        const bool overBudget = on && budget > 0 && !alarmActive_ && startsLastHour() >= budget;
+        if (dwelling || overBudget)
+        {
+            if (!deferring_)
+            {
+                deferring_ = true;
+                deferred_++;
+            }
+            return false;
+        }
+    }
+
+    relay_.set(on);
+    if (on)
+    {
+        startLog_[startHead_] = now;
+        startHead_ = static_cast<uint8_t>((startHead_ + 1) % MAX_TRACKED_STARTS);
+        starts_++;
+    }
+    else if (switched_)
+    {
+        onTimeMs_ += now - lastSwitchMs_;
+    }
+    switches_++;
+    switched_ = true;
+    lastSwitchMs_ = now;
+    deferring_ = false;
+    return true;
+}
+
+bool BoilerController::stopRelay(StopReason reason, bool exempt)
+{
+    if (!relay_.get())
+    {
+        return true;
+    }
+    if (!switchRelay(false, exempt))
+    {
+        return false;
+    }
+    stopReason_ = reason;
+    return true;
+}
+
+uint8_t BoilerController::startsLastHour() const
+{
+    const uint32_t now = clock_.millis();
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < MAX_TRACKED_STARTS && i < starts_; ++i)
+    {
+        if (now - startLog_[i] < 3600UL * 1000UL)
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+uint32_t BoilerController::onTimeSec() const
+{
+    uint32_t ms = onTimeMs_;
+    if (switched_ && relay_.get())
+    {
+        ms += clock_.millis() - lastSwitchMs_;
+    }
+    return ms / 1000UL;
+}
+
+void BoilerController::clearWillShower()
+{
+    if (willShowerRequested_)
+    {
+        willShowerRequested_ = false;
+        events_.onWillShowerCleared();
+    }
+}
@@ -0,0 +1,161 @@
+#ifndef BOILER_CONTROL_H
+#define BOILER_CONTROL_H
+
+#pragma once
+
+#include <cstdint>
+
+// Pure boiler control core (no Arduino dependencies).
+// All hardware, time and MQTT access goes through the small interfaces below,
+// so the same logic runs on the ESP32 and in the native unit tests.
+
+struct BoilerConfig
+{
+    bool enabled = true;            // enable/disable boiler control
+    float onThreshold = 60.0f;      // temperature to turn boiler on / under-temperature alarm
+    float offThreshold = 78.0f;     // temperature to turn boiler off ("you can shower now")
+    int boilerTimeMin = 120;        // max time boiler is allowed to heat
+    bool stopTimerOnTarget = false; // stop timer when off-threshold reached
+    bool onlyOncePerPeriod = true;  // publish '1' only once per period
+    bool earlyStop = false;         // stop once the learned overshoot will carry the tank to offThreshold
+    int minOnSec = 0;               // anti-short-cycle: relay stays on at least this long (up to MAX_DWELL_OVERSHOOT_C past target)
+    int minOffSec = 0;              // anti-short-cycle: relay stays off at least this long
+    int maxStartsPerHour = 0;       // burner start budget over a sliding hour (0 = unlimited, ignored while the alarm is active)
+};
+
+// Why the relay was last switched off by the controller (recorded in the session log).
+enum class StopReason : uint8_t
+{
+    None = 0,
+    TargetReached,
+    EarlyStop,
+    TimerExpired,
+    Cancelled,
+    Disabled,
+};
+
+const char *stopReasonName(StopReason reason);
+
+class BoilerRelay
+{
+public:
+    virtual ~BoilerRelay() = default;
+    virtual bool get() const = 0;
+    virtual void set(bool on) = 0;
+};
+
+class BoilerClock
+{
+public:
+    virtual ~BoilerClock() = default;
+    virtual uint32_t millis() const = 0;
+    virtual int64_t epochSeconds() const = 0; // 0 (or small) while NTP is not synced
+};
+
+// Side effects of autonomous control decisions (MQTT publish, logging).
+class BoilerEvents
+{
+public:
+    virtual ~BoilerEvents() = default;
+    virtual void onWillShowerCleared() {}
+    virtual void onAlarmChanged(bool /*active*/, float /*temperature*/) {}
+    virtual void onForcedHeatingStart(int /*minutes*/) {}
+    virtual void onEarlyStop(float /*temperature*/, float /*marginC*/) {}
+};
+
+class BoilerController
+{
+public:
+    static constexpr uint32_t CHECK_INTERVAL_MS = 1000;
+    static constexpr float ALARM_HYSTERESIS_C = 2.0f;
+    static constexpr float MAX_DWELL_OVERSHOOT_C = 2.0f; // the min-on dwell never heats further past offThreshold
+    static constexpr int DEFAULT_SHOWER_MIN = 60;
+    static constexpr uint8_t MAX_TRACKED_STARTS = 16; // upper bound for maxStartsPerHour
+
+    struct ShowerNotice
+    {
+        bool publish = false;
+        bool value = false;
+        bool retained = false;
+    };
+
+    BoilerController(BoilerRelay &relay, BoilerClock &clock, BoilerEvents &events);
+
+    BoilerConfig &config() { return config_; }
+    const BoilerConfig &config() const { return config_; }
+
+    void setTemperature(float temperature) { temperature_ = temperature; }
+    float temperature() const { return temperature_; }
+    int timeRemaining() const { return timeRemainingSec_; }
+    bool willShowerRequested() const { return willShowerRequested_; }
+    bool alarmActive() const { return alarmActive_; }
+
+    // Expected rise after the relay goes off (from TankModel); used by config().earlyStop.
+    void setStopMargin(float marginC) { stopMarginC_ = marginC > 0.0f ? marginC : 0.0f; }
+    float stopMargin() const { return stopMarginC_; }
+    uint32_t earlyStopCount() const { return earlyStops_; }
+    StopReason lastStopReason() const { return stopReason_; }
+
+    // Relay wear counters (switches = on + off transitions)
+    uint32_t switchCount() const { return switches_; }
+    uint32_t startCount() const { return starts_; }
+    uint32_t onTimeSec() const;
+    uint8_t startsLastHour() const;
+    // Switch requests held back by the dwell times or the start budget (counted once per episode)
+    uint32_t deferredCount() const { return deferred_; }
+
+    // One control step, evaluated at most once per CHECK_INTERVAL_MS.
+    void tick(bool forceOn = false);
+    // Under-temperature alarm with hysteresis; an alarm edge forces heating on the next control
+    // step (latched, so an edge between two steps is not lost).
+    void updateAlarm();
+
+    // Inputs (UI, HW button, MQTT)
+    void startShowerTimer(int minutes);
+    void setShowerRequest(bool requested);
+
+    bool canShowerNow() const;
+    long currentPeriodId() const;
+
+    // Decide what to publish on the YouCanShowerNow topic (once-per-period gating).
+    ShowerNotice evaluateShowerNotice(bool retained);
+    void resetShowerNotice();
+
+private:
+    void clearWillShower();
+    // Every relay change goes through here; dwell times and the start budget apply unless exempt
+    // (user cancel and disabling switch off immediately). Returns true if the relay is in the requested state.
+    bool switchRelay(bool on, bool exempt = false);
+    bool stopRelay(StopReason reason, bool exempt = false);
+
+    BoilerRelay &relay_;
+    BoilerClock &clock_;
+    BoilerEvents &events_;
+    BoilerConfig config_;
+
+    float temperature_ = 70.0f;
+    int timeRemainingSec_ = 0;
+    bool willShowerRequested_ = false;
+    bool alarmActive_ = false;
+    bool forcePending_ = false; // alarm edge waiting for the next control step
+    uint32_t lastCheckMs_ = 0;
+    bool checked_ = false; // the first step is never gated (boot decision right after the first reading)
+    float stopMarginC_ = 0.0f;
+    uint32_t earlyStops_ = 0;
+    StopReason stopReason_ = StopReason::None;
+
+    bool switched_ = false; // lastSwitchMs_ valid
+    uint32_t lastSwitchMs_ = 0;
+    uint32_t switches_ = 0;
+    uint32_t starts_ = 0;
+    uint32_t onTimeMs_ = 0;
+    uint32_t deferred_ = 0;
+    bool deferring_ = false;
+    uint32_t startLog_[MAX_TRACKED_STARTS] = {}; // ring of recent start times
+    uint8_t startHead_ = 0;
+
+    long lastShower1PeriodId_ = -1;
+    bool lastPublishedShower_ = false;
+};
+
+#endif // BOILER_CONTROL_H
@@ -0,0 +1,59 @@
+#include "BootTimeline.h"
+
+#include <cstdio>
+
+BootTimeline::BootTimeline(const char *const *names, uint8_t stageCount)
+    : names_(names), count_(stageCount < MAX_STAGES ? stageCount : MAX_STAGES)
+{
+}
+
+void BootTimeline::start(uint8_t stage, uint32_t nowMs)
+{
+    if (stage >= count_)
+    {
+        return;
+    }
+    startMs_[stage] = nowMs;
+    started_ |= 1u << stage;
+}
+
+void BootTimeline::finish(uint8_t stage, uint32_t nowMs)
+{
+    if (stage >= count_)
+    {
+        return;
+    }
+    if (!started(stage))
+    {
+        start(stage, nowMs);
+    }
+    endMs_[stage] = nowMs;
+    finished_ |= 1u << stage;
+}
+
+uint32_t BootTimeline::durationMs(uint8_t stage) const
+{
+    return finished(stage) ? endMs_[stage] - startMs_[stage] : 0;
+}
+
+void BootTimeline::format(char *out, uint32_t size) const
+{
+    if (size == 0)
+    {
+        return;
+    }
+    out[0] = '\0';
+    uint32_t used = 0;
+    for (uint8_t i = 0; i < count_ && used < size; ++i)
+    {
+        const char *sep = i == 0 ? "" : " | ";
+        const int n = finished(i)
+                          ? snprintf(out + used, size - used, "%s%s %lu", sep, names_[i], (unsigned long)durationMs(i))
+                          : snprintf(out + used, size - used, "%s%s -", sep, names_[i]);
+        if (n < 0)
+        {
+            break;
+        }
+        used += static_cast<uint32_t>(n);
+    }
+}
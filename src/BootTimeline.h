@@ -0,0 +1,46 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#pragma once
+
+#include <cstdint>
+
+// Start/end times of the boot stages (no Arduino dependencies). Times are absolute millis(),
+// so offsets read as "ms after reset". Stages need not be contiguous: the lazy stages run from
+// loop passes with control work in between, which is why each one keeps its own start.
+class BootTimeline
+{
+public:
+    static constexpr uint8_t MAX_STAGES = 12;
+
+    // Names must outlive the timeline.
+    explicit BootTimeline(const char *const *names, uint8_t stageCount);
+
+    void start(uint8_t stage, uint32_t nowMs);
+    void finish(uint8_t stage, uint32_t nowMs);
+
+    uint8_t stageCount() const { return count_; }
+    const char *name(uint8_t stage) const { return stage < count_ ? names_[stage] : "?"; }
+    bool started(uint8_t stage) const { return stage < count_ && (started_ & (1u << stage)); }
+    bool finished(uint8_t stage) const { return stage < count_ && (finished_ & (1u << stage)); }
+    bool complete() const { return count_ > 0 && finished_ == allMask(); }
+    // Time spent inside the stage (0 until finished).
+    uint32_t durationMs(uint8_t stage) const;
+    // When the stage finished, in ms after reset (0 until finished).
+    uint32_t doneAtMs(uint8_t stage) const { return finished(stage) ? endMs_[stage] : 0; }
+
+    // "settings 41 | sensor 196 | ..." durations in stage order; unfinished stages show "-".
+    void format(char *out, uint32_t size) const;
+
+private:
+    uint32_t allMask() const { return (1u << count_) - 1u; }
+
+    const char *const *names_;
+    uint8_t count_;
+    uint32_t started_ = 0;
+    uint32_t finished_ = 0;
+    uint32_t startMs_[MAX_STAGES] = {};
+    uint32_t endMs_[MAX_STAGES] = {};
+};
+
+#endif // BOOT_TIMELINE_H
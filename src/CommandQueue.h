@@ -0,0 +1,108 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free queue: any number of producer tasks, one consumer (bounded MPMC ring with a
+// sequence number per cell, used here with a single consumer). push() never blocks; when the
+// ring is full it fails and counts a drop, which is the back-pressure signal for the caller.
+// N must be a power of two. T must be trivially copyable.
+template <typename T, size_t N>
+class CommandQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "CommandQueue size must be a power of two");
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    CommandQueue()
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer side, any task.
+    bool push(const T &value)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        for (;;)
+        {
+            cell = &cells_[pos & (N - 1)];
+            const size_t seq = cell->seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed); // full
+                return false;
+            }
+            else
+            {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+
+        const uint32_t depth = static_cast<uint32_t>(pos + 1 - tail_.load(std::memory_order_relaxed));
+        uint32_t high = highWater_.load(std::memory_order_relaxed);
+        while (depth > high && !highWater_.compare_exchange_weak(high, depth, std::memory_order_relaxed))
+        {
+        }
+        return true;
+    }
+
+    // Consumer side, one task only.
+    bool pop(T &out)
+    {
+        const size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell &cell = cells_[pos & (N - 1)];
+        const size_t seq = cell.seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+        {
+            return false; // empty (or the producer of this cell has not finished yet)
+        }
+        out = cell.value;
+        cell.seq.store(pos + N, std::memory_order_release);
+        tail_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t size() const
+    {
+        return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+    }
+    uint32_t pushedCount() const { return pushed_.load(std::memory_order_relaxed); }
+    uint32_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint32_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq{0};
+        T value = {};
+    };
+
+    Cell cells_[N];
+    std::atomic<size_t> head_{0}; // next enqueue position (producers)
+    std::atomic<size_t> tail_{0}; // next dequeue position (consumer)
+    std::atomic<uint32_t> pushed_{0};
+    std::atomic<uint32_t> dropped_{0};
+    std::atomic<uint32_t> highWater_{0};
+};
+
+#endif // COMMAND_QUEUE_H
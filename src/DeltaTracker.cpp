@@ -0,0 +1,55 @@
+#include "DeltaTracker.h"
+
+DeltaTracker::DeltaTracker(uint8_t fieldCount, uint32_t minIntervalMs)
+    : count_(fieldCount > MAX_FIELDS ? MAX_FIELDS : fieldCount), minIntervalMs_(minIntervalMs)
+{
+}
+
+uint32_t DeltaTracker::update(const int32_t *values)
+{
+    uint32_t changed = 0;
+    for (uint8_t i = 0; i < count_; ++i)
+    {
+        if (!primed_ || values[i] != last_[i])
+        {
+            changed |= 1u << i;
+            last_[i] = values[i];
+        }
+    }
+    primed_ = true;
+    coalesced_ += static_cast<uint32_t>(__builtin_popcount(changed & pending_));
+    pending_ |= changed;
+    return changed;
+}
+
+uint32_t DeltaTracker::takeDue(uint32_t nowMs)
+{
+    if (pending_ == 0 || (takenOnce_ && nowMs - lastTakeMs_ < minIntervalMs_))
+    {
+        return 0;
+    }
+    const uint32_t mask = pending_;
+    pending_ = 0;
+    lastTakeMs_ = nowMs;
+    takenOnce_ = true;
+    taken_++;
+    return mask;
+}
+
+uint32_t DeltaTracker::nextDueMs(uint32_t nowMs) const
+{
+    if (pending_ == 0)
+    {
+        return UINT32_MAX;
+    }
+    if (!takenOnce_ || nowMs - lastTakeMs_ >= minIntervalMs_)
+    {
+        return nowMs;
+    }
+    return lastTakeMs_ + minIntervalMs_;
+}
+
+void DeltaTracker::invalidate()
+{
+    pending_ = allMask();
+}
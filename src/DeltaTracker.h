@@ -0,0 +1,49 @@
+#ifndef DELTA_TRACKER_H
+#define DELTA_TRACKER_H
+
+#pragma once
+
+#include <cstdint>
+
+// Change mask for a fixed set of integer-coded fields, drained at a bounded rate
+// (no Arduino dependencies). update() compares against the last values and ORs changed fields
+// into the pending mask; takeDue() hands the mask out at most once per minIntervalMs, so a
+// burst of changes is coalesced into one delta instead of one message per change.
+class DeltaTracker
+{
+public:
+    static constexpr uint8_t MAX_FIELDS = 32;
+
+    explicit DeltaTracker(uint8_t fieldCount = MAX_FIELDS, uint32_t minIntervalMs = 1000);
+
+    void setMinInterval(uint32_t minIntervalMs) { minIntervalMs_ = minIntervalMs; }
+
+    // Returns the mask of fields that changed with this call (first call: all fields).
+    uint32_t update(const int32_t *values);
+    // Pending mask if the rate limit allows sending now, else 0. Clears what it returns.
+    uint32_t takeDue(uint32_t nowMs);
+    // Next time takeDue() can return something (nowMs when due, UINT32_MAX when idle).
+    uint32_t nextDueMs(uint32_t nowMs) const;
+    // Mark everything pending again (e.g. all consumers need a resync).
+    void invalidate();
+
+    uint32_t pending() const { return pending_; }
+    int32_t value(uint8_t field) const { return field < count_ ? last_[field] : 0; }
+    uint32_t deltasTaken() const { return taken_; }
+    uint32_t changesCoalesced() const { return coalesced_; } // changes merged into an already pending field
+
+private:
+    uint32_t allMask() const { return count_ >= 32 ? 0xFFFFFFFFu : ((1u << count_) - 1u); }
+
+    int32_t last_[MAX_FIELDS] = {};
+    uint8_t count_;
+    bool primed_ = false;
+    uint32_t pending_ = 0;
+    uint32_t minIntervalMs_;
+    uint32_t lastTakeMs_ = 0;
+    bool takenOnce_ = false;
+    uint32_t taken_ = 0;
+    uint32_t coalesced_ = 0;
+};
+
+#endif // DELTA_TRACKER_H
@@ -0,0 +1,136 @@
+#include "DisplayDirty.h"
+
+#include <cstring>
+
+void DisplayDirtyTracker::markRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (w <= 0 || h <= 0)
+    {
+        return;
+    }
+    int16_t x0 = x < 0 ? 0 : x;
+    int16_t x1 = x + w - 1;
+    int16_t y0 = y < 0 ? 0 : y;
+    int16_t y1 = y + h - 1;
+    if (x1 >= WIDTH)
+    {
+        x1 = WIDTH - 1;
+    }
+    if (y1 >= PAGES * 8)
+    {
+        y1 = PAGES * 8 - 1;
+    }
+    if (x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+
+    for (int16_t page = y0 / 8; page <= y1 / 8; ++page)
+    {
+        Span &s = spans_[page];
+        if (x0 < s.first)
+        {
+            s.first = static_cast<uint8_t>(x0);
+        }
+        if (x1 > s.last)
+        {
+            s.last = static_cast<uint8_t>(x1);
+        }
+    }
+}
+
+void DisplayDirtyTracker::markAll()
+{
+    markRect(0, 0, WIDTH, PAGES * 8);
+}
+
+bool DisplayDirtyTracker::dirty() const
+{
+    for (const Span &s : spans_)
+    {
+        if (s.first <= s.last)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t DisplayDirtyTracker::commit(const uint8_t *frame)
+{
+    if (!frame)
+    {
+        return 0;
+    }
+
+    size_t bytes = 0;
+    for (uint8_t page = 0; page < PAGES; ++page)
+    {
+        Span &s = spans_[page];
+        if (s.first > s.last)
+        {
+            continue;
+        }
+        const uint8_t *row = frame + page * WIDTH;
+        uint8_t *shadowRow = shadow_ + page * WIDTH;
+
+        uint8_t first = s.first;
+        uint8_t last = s.last;
+        while (first <= last && row[first] == shadowRow[first])
+        {
+            first++;
+        }
+        while (last > first && row[last] == shadowRow[last])
+        {
+            last--;
+        }
+        if (first > last)
+        {
+            s = Span(); // redrawn, but pixel-identical
+            continue;
+        }
+
+        memcpy(shadowRow + first, row + first, last - first + 1);
+        s.first = first;
+        s.last = last;
+        bytes += last - first + 1;
+    }
+
+    if (bytes > 0)
+    {
+        flushes_++;
+        sent_ += bytes;
+        saved_ += FRAME_BYTES - bytes;
+    }
+    return bytes;
+}
+
+bool DisplayDirtyTracker::span(uint8_t page, uint8_t &first, uint8_t &last) const
+{
+    if (page >= PAGES || spans_[page].first > spans_[page].last)
+    {
+        return false;
+    }
+    first = spans_[page].first;
+    last = spans_[page].last;
+    return true;
+}
+
+void DisplayDirtyTracker::clear()
+{
+    for (Span &s : spans_)
+    {
+        s = Span();
+    }
+}
+
+void DisplayDirtyTracker::syncAll(const uint8_t *frame)
+{
+    if (frame)
+    {
+        memcpy(shadow_, frame, FRAME_BYTES);
+        flushes_++;
+        sent_ += FRAME_BYTES;
+    }
+    clear();
+}
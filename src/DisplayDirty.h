@@ -0,0 +1,52 @@
+#ifndef DISPLAY_DIRTY_H
+#define DISPLAY_DIRTY_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Dirty-region tracking for a page-organised SSD1306 framebuffer (128 columns x 4 pages,
+// one byte = 8 vertical pixels). Text fields mark the rectangles they redraw; commit()
+// compares those spans against a shadow of what the panel shows and shrinks them to the
+// columns that really changed, so only those bytes have to go over I2C.
+class DisplayDirtyTracker
+{
+public:
+    static constexpr uint8_t WIDTH = 128;
+    static constexpr uint8_t PAGES = 4;
+    static constexpr size_t FRAME_BYTES = static_cast<size_t>(WIDTH) * PAGES;
+
+    void markRect(int16_t x, int16_t y, int16_t w, int16_t h);
+    void markAll();
+    bool dirty() const;
+
+    // Narrow the dirty spans against the shadow, copy the changed bytes into it and count
+    // the transfer. Returns the number of data bytes to send (0 = nothing changed).
+    size_t commit(const uint8_t *frame);
+    // Column span of a page after commit(); false when the page has nothing to send.
+    bool span(uint8_t page, uint8_t &first, uint8_t &last) const;
+    void clear();
+
+    // The whole frame was pushed some other way (display.display()); resync the shadow.
+    void syncAll(const uint8_t *frame);
+
+    uint32_t flushCount() const { return flushes_; }
+    uint32_t bytesSent() const { return sent_; }
+    uint32_t bytesSaved() const { return saved_; }
+
+private:
+    struct Span
+    {
+        uint8_t first = WIDTH; // first > last = clean
+        uint8_t last = 0;
+    };
+
+    Span spans_[PAGES];
+    uint8_t shadow_[FRAME_BYTES] = {};
+    uint32_t flushes_ = 0;
+    uint32_t sent_ = 0;
+    uint32_t saved_ = 0;
+};
+
+#endif // DISPLAY_DIRTY_H
@@ -0,0 +1,78 @@
+#include "HeapProbe.h"
+
+#include <esp_heap_caps.h>
+
+uint32_t HeapProbe::lastAllocs_ = 0;
+uint32_t HeapProbe::maxAllocs_ = 0;
+uint32_t HeapProbe::windows_ = 0;
+uint32_t HeapProbe::dirtyWindows_ = 0;
+
+static volatile TaskHandle_t s_probeTask = nullptr;
+static volatile uint32_t s_windowAllocs = 0;
+
+#if BOILER_HEAP_PROBE
+static inline void noteAlloc()
+{
+    if (s_probeTask && xTaskGetCurrentTaskHandle() == s_probeTask)
+    {
+        s_windowAllocs = s_windowAllocs + 1;
+    }
+}
+
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t count, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+
+    void *__wrap_malloc(size_t size)
+    {
+        noteAlloc();
+        return __real_malloc(size);
+    }
+
+    void *__wrap_calloc(size_t count, size_t size)
+    {
+        noteAlloc();
+        return __real_calloc(count, size);
+    }
+
+    void *__wrap_realloc(void *ptr, size_t size)
+    {
+        noteAlloc();
+        return __real_realloc(ptr, size);
+    }
+}
+#endif
+
+void HeapProbe::begin()
+{
+    s_windowAllocs = 0;
+    s_probeTask = xTaskGetCurrentTaskHandle();
+}
+
+void HeapProbe::end()
+{
+    s_probeTask = nullptr;
+    lastAllocs_ = s_windowAllocs;
+    if (lastAllocs_ > maxAllocs_)
+    {
+        maxAllocs_ = lastAllocs_;
+    }
+    if (lastAllocs_ > 0)
+    {
+        dirtyWindows_++;
+    }
+    windows_++;
+}
+
+uint8_t HeapProbe::fragmentationPct()
+{
+    const size_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    if (freeBytes == 0)
+    {
+        return 100;
+    }
+    const size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    return static_cast<uint8_t>(100 - (largest * 100) / freeBytes);
+}
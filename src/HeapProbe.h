@@ -0,0 +1,37 @@
+#ifndef HEAP_PROBE_H
+#define HEAP_PROBE_H
+
+#pragma once
+
+#include <Arduino.h>
+
+// Heap allocation probe.
+// Counts malloc/calloc/realloc calls made by the calling task between begin() and end().
+// Counting needs the link-time wrappers (-Wl,--wrap=malloc,... with BOILER_HEAP_PROBE=1);
+// without them the probe only reports heap fragmentation.
+#ifndef BOILER_HEAP_PROBE
+#define BOILER_HEAP_PROBE 0
+#endif
+
+class HeapProbe
+{
+public:
+    static void begin();
+    static void end();
+
+    static uint32_t lastAllocs() { return lastAllocs_; }
+    static uint32_t maxAllocs() { return maxAllocs_; }
+    static uint32_t windows() { return windows_; }
+    static uint32_t windowsWithAllocs() { return dirtyWindows_; }
+
+    // 0 = one contiguous free block, 100 = completely fragmented (default 8-bit heap)
+    static uint8_t fragmentationPct();
+
+private:
+    static uint32_t lastAllocs_;
+    static uint32_t maxAllocs_;
+    static uint32_t windows_;
+    static uint32_t dirtyWindows_;
+};
+
+#endif // HEAP_PROBE_H
@@ -0,0 +1,243 @@
+#include "HeatSchedule.h"
+
+namespace
+{
+    const char DAY_NAMES[7][3] = {"mo", "tu", "we", "th", "fr", "sa", "su"};
+
+    inline char lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    inline bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    void skipSpaces(const char *&p)
+    {
+        while (isSpace(*p))
+        {
+            ++p;
+        }
+    }
+
+    // Day index 0..6 (Monday first) or -1
+    int parseDay(const char *&p)
+    {
+        for (int d = 0; d < 7; ++d)
+        {
+            if (lower(p[0]) == DAY_NAMES[d][0] && lower(p[1]) == DAY_NAMES[d][1])
+            {
+                p += 2;
+                return d;
+            }
+        }
+        return -1;
+    }
+
+    // Bitmask of days (bit 0 = Monday) or 0 on error
+    uint8_t parseDays(const char *&p)
+    {
+        if (*p == '*')
+        {
+            ++p;
+            return 0x7F;
+        }
+        uint8_t mask = 0;
+        while (true)
+        {
+            const int first = parseDay(p);
+            if (first < 0)
+            {
+                return 0;
+            }
+            int last = first;
+            if (*p == '-')
+            {
+                ++p;
+                last = parseDay(p);
+                if (last < 0)
+                {
+                    return 0;
+                }
+            }
+            for (int d = first;; d = (d + 1) % 7) // Fr-Mo wraps over the weekend
+            {
+                mask |= static_cast<uint8_t>(1u << d);
+                if (d == last)
+                {
+                    break;
+                }
+            }
+            if (*p != ',')
+            {
+                return mask;
+            }
+            ++p;
+        }
+    }
+
+    // Minutes of the day or -1
+    int parseTime(const char *&p)
+    {
+        int hour = 0;
+        int digits = 0;
+        while (isDigit(*p) && digits < 2)
+        {
+            hour = hour * 10 + (*p++ - '0');
+            digits++;
+        }
+        if (digits == 0 || *p != ':' || !isDigit(p[1]) || !isDigit(p[2]))
+        {
+            return -1;
+        }
+        const int minute = (p[1] - '0') * 10 + (p[2] - '0');
+        p += 3;
+        if (hour > 23 || minute > 59)
+        {
+            return -1;
+        }
+        return hour * 60 + minute;
+    }
+}
+
+uint16_t HeatSchedule::minuteOfWeek(int tmWday, int tmHour, int tmMin)
+{
+    const int day = (tmWday + 6) % 7; // Monday = 0
+    return static_cast<uint16_t>(day * MINUTES_PER_DAY + tmHour * 60 + tmMin);
+}
+
+void HeatSchedule::clear()
+{
+    count_ = 0;
+    for (uint8_t &idx : hourIndex_)
+    {
+        idx = 0;
+    }
+}
+
+bool HeatSchedule::compile(const char *plan)
+{
+    uint16_t table[MAX_TARGETS];
+    uint8_t n = 0;
+    const char *p = plan ? plan : "";
+
+    while (*p)
+    {
+        skipSpaces(p);
+        if (*p == ';')
+        {
+            ++p;
+            continue;
+        }
+        if (*p == '\0')
+        {
+            break;
+        }
+
+        const uint8_t days = parseDays(p);
+        if (days == 0 || !isSpace(*p))
+        {
+            errorOffset_ = static_cast<int>(p - plan);
+            return false;
+        }
+
+        bool anyTime = false;
+        while (true)
+        {
+            skipSpaces(p);
+            if (*p == ';' || *p == '\0')
+            {
+                break;
+            }
+            const char *timeStart = p;
+            const int minuteOfDay = parseTime(p);
+            if (minuteOfDay < 0 || !(isSpace(*p) || *p == ';' || *p == '\0'))
+            {
+                errorOffset_ = static_cast<int>(timeStart - plan);
+                return false;
+            }
+            anyTime = true;
+            for (uint8_t d = 0; d < 7; ++d)
+            {
+                if (!(days & (1u << d)))
+                {
+                    continue;
+                }
+                const uint16_t t = static_cast<uint16_t>(d * MINUTES_PER_DAY + minuteOfDay);
+                // Sorted insert, duplicates collapse
+                uint8_t pos = 0;
+                while (pos < n && table[pos] < t)
+                {
+                    ++pos;
+                }
+                if (pos < n && table[pos] == t)
+                {
+                    continue;
+                }
+                if (n >= MAX_TARGETS)
+                {
+                    errorOffset_ = static_cast<int>(timeStart - plan);
+                    return false;
+                }
+                for (uint8_t i = n; i > pos; --i)
+                {
+                    table[i] = table[i - 1];
+                }
+                table[pos] = t;
+                ++n;
+            }
+        }
+        if (!anyTime)
+        {
+            errorOffset_ = static_cast<int>(p - plan);
+            return false;
+        }
+    }
+
+    for (uint8_t i = 0; i < n; ++i)
+    {
+        targets_[i] = table[i];
+    }
+    count_ = n;
+    uint8_t idx = 0;
+    for (uint16_t hour = 0; hour < 7 * 24; ++hour)
+    {
+        while (idx < count_ && targets_[idx] < hour * 60)
+        {
+            ++idx;
+        }
+        hourIndex_[hour] = idx;
+    }
+    errorOffset_ = -1;
+    return true;
+}
+
+HeatSchedule::Next HeatSchedule::next(uint16_t minuteOfWeek) const
+{
+    Next result;
+    if (count_ == 0)
+    {
+        return result;
+    }
+    minuteOfWeek %= MINUTES_PER_WEEK;
+    uint8_t idx = hourIndex_[minuteOfWeek / 60];
+    while (idx < count_ && targets_[idx] < minuteOfWeek) // only targets within the same hour
+    {
+        ++idx;
+    }
+    if (idx == count_)
+    {
+        idx = 0; // wrap into next week
+    }
+    result.index = idx;
+    result.minuteOfWeek = targets_[idx];
+    result.minutesUntil = static_cast<uint16_t>((targets_[idx] + MINUTES_PER_WEEK - minuteOfWeek) % MINUTES_PER_WEEK);
+    return result;
+}
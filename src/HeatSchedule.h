@@ -0,0 +1,50 @@
+#ifndef HEAT_SCHEDULE_H
+#define HEAT_SCHEDULE_H
+
+#pragma once
+
+#include <cstdint>
+
+// Weekly shower plan compiled into a sorted table of target times (no Arduino dependencies).
+// Times are minutes of the week, Monday 00:00 = 0. The plan text is a ';' separated list of
+// "<days> <HH:MM> [<HH:MM> ...]" entries, days as Mo..Su, ranges (Mo-Fr) and lists (Sa,Su)
+// or '*' for every day, e.g. "Mo-Fr 06:30 20:00; Sa,Su 08:00".
+// An hour-of-week index maps every lookup to its first candidate, so next() is O(1).
+class HeatSchedule
+{
+public:
+    static constexpr uint16_t MINUTES_PER_DAY = 24 * 60;
+    static constexpr uint16_t MINUTES_PER_WEEK = 7 * MINUTES_PER_DAY;
+    static constexpr uint8_t MAX_TARGETS = 32;
+    static constexpr uint8_t NONE = 0xFF;
+
+    struct Next
+    {
+        uint8_t index = NONE;     // position in the table, NONE when the plan is empty
+        uint16_t minuteOfWeek = 0; // target time
+        uint16_t minutesUntil = 0; // 0 = the target is this minute
+    };
+
+    // Parse and compile the plan. On a syntax error the previous table stays active and
+    // errorOffset() points at the offending character.
+    bool compile(const char *plan);
+    void clear();
+
+    // Next target at or after minuteOfWeek (wraps into the following week).
+    Next next(uint16_t minuteOfWeek) const;
+
+    uint8_t count() const { return count_; }
+    uint16_t target(uint8_t index) const { return index < count_ ? targets_[index] : 0; }
+    int errorOffset() const { return errorOffset_; }
+
+    // Helpers for callers working with struct tm (tm_wday: 0 = Sunday).
+    static uint16_t minuteOfWeek(int tmWday, int tmHour, int tmMin);
+
+private:
+    uint16_t targets_[MAX_TARGETS] = {};
+    uint8_t count_ = 0;
+    uint8_t hourIndex_[7 * 24] = {}; // first target >= start of that hour (count_ = none left this week)
+    int errorOffset_ = -1;
+};
+
+#endif // HEAT_SCHEDULE_H
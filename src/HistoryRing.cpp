@@ -0,0 +1,221 @@
+#include "HistoryRing.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    int16_t quantize(float temperature)
+    {
+        const float q = std::round(temperature * HistoryRing::TEMP_SCALE);
+        if (q > INT16_MAX)
+        {
+            return INT16_MAX;
+        }
+        if (q < INT16_MIN)
+        {
+            return INT16_MIN;
+        }
+        return static_cast<int16_t>(q);
+    }
+}
+
+void HistoryRing::clear()
+{
+    totalBlocks_ = 0;
+    samples_ = 0;
+    lastTime_ = 0;
+    lastTempQ_ = 0;
+}
+
+void HistoryRing::startBlock(uint32_t time, int16_t tempQ, bool relay)
+{
+    if (totalBlocks_ >= MAX_BLOCKS)
+    {
+        samples_ -= 1U + blockAt(totalBlocks_).count; // slot being reused holds the oldest block
+    }
+    Block &b = blocks_[totalBlocks_ % MAX_BLOCKS];
+    b.t0 = time;
+    b.temp0 = tempQ;
+    b.relay0 = relay ? 1 : 0;
+    b.count = 0;
+    memset(b.deltas, 0, sizeof(b.deltas));
+    totalBlocks_++;
+}
+
+bool HistoryRing::append(uint32_t time, float temperature, bool relay)
+{
+    const int16_t tempQ = quantize(temperature);
+
+    if (totalBlocks_ > 0)
+    {
+        if (time <= lastTime_)
+        {
+            return false;
+        }
+        Block &b = blocks_[(totalBlocks_ - 1) % MAX_BLOCKS];
+        const uint32_t dt = time - lastTime_;
+        const int32_t dTemp = static_cast<int32_t>(tempQ) - lastTempQ_;
+        if (b.count < DELTAS_PER_BLOCK && dt <= 255 && dTemp >= -64 && dTemp <= 63)
+        {
+            b.deltas[b.count * 2] = static_cast<uint8_t>(dt);
+            b.deltas[b.count * 2 + 1] = static_cast<uint8_t>((static_cast<uint8_t>(dTemp) << 1) | (relay ? 1 : 0));
+            b.count++;
+            samples_++;
+            lastTime_ = time;
+            lastTempQ_ = tempQ;
+            return true;
+        }
+    }
+
+    startBlock(time, tempQ, relay);
+    samples_++;
+    lastTime_ = time;
+    lastTempQ_ = tempQ;
+    return true;
+}
+
+uint32_t HistoryRing::oldestTime() const
+{
+    return totalBlocks_ ? blockAt(oldestBlock()).t0 : 0;
+}
+
+HistoryRing::Cursor HistoryRing::seek(uint32_t fromTime) const
+{
+    Cursor c;
+    c.block = oldestBlock();
+    if (totalBlocks_ == 0)
+    {
+        return c;
+    }
+
+    // Last block whose key sample is <= fromTime (blocks are in time order).
+    uint32_t lo = oldestBlock();
+    uint32_t hi = totalBlocks_ - 1;
+    if (blockAt(lo).t0 < fromTime)
+    {
+        while (lo < hi)
+        {
+            const uint32_t mid = lo + (hi - lo + 1) / 2;
+            if (blockAt(mid).t0 <= fromTime)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+    }
+    c.block = lo;
+
+    // Walk inside the block to the first sample >= fromTime.
+    Cursor probe = c;
+    Sample s;
+    while (next(probe, s))
+    {
+        if (s.time >= fromTime)
+        {
+            break;
+        }
+        c = probe;
+    }
+    return c;
+}
+
+bool HistoryRing::next(Cursor &cursor, Sample &out) const
+{
+    if (totalBlocks_ == 0)
+    {
+        return false;
+    }
+    if (cursor.block < oldestBlock())
+    {
+        cursor = Cursor(); // overwritten while iterating: continue at the oldest data
+        cursor.block = oldestBlock();
+    }
+
+    for (;;)
+    {
+        if (cursor.block >= totalBlocks_)
+        {
+            return false;
+        }
+        const Block &b = blockAt(cursor.block);
+        if (cursor.entry == 0)
+        {
+            cursor.time = b.t0;
+            cursor.tempQ = b.temp0;
+            out.relay = b.relay0 != 0;
+            break;
+        }
+        if (cursor.entry <= b.count)
+        {
+            const uint8_t dt = b.deltas[(cursor.entry - 1) * 2];
+            const uint8_t packed = b.deltas[(cursor.entry - 1) * 2 + 1];
+            cursor.time += dt;
+            cursor.tempQ = static_cast<int16_t>(cursor.tempQ + (static_cast<int8_t>(packed) >> 1));
+            out.relay = (packed & 1) != 0;
+            break;
+        }
+        if (cursor.block + 1 >= totalBlocks_)
+        {
+            return false; // end of the newest block, more may be appended later
+        }
+        cursor.block++;
+        cursor.entry = 0;
+    }
+
+    out.time = cursor.time;
+    out.temperature = cursor.tempQ / TEMP_SCALE;
+    cursor.entry++;
+    return true;
+}
+
+size_t HistoryRing::writeCsv(Cursor &cursor, uint32_t toTime, char *out, size_t outLen) const
+{
+    size_t used = 0;
+    for (;;)
+    {
+        Cursor peek = cursor;
+        Sample s;
+        if (!next(peek, s) || s.time > toTime)
+        {
+            break;
+        }
+        char line[32];
+        const int n = snprintf(line, sizeof(line), "%lu,%.2f,%d\n", (unsigned long)s.time, s.temperature, s.relay ? 1 : 0);
+        if (n <= 0 || used + static_cast<size_t>(n) > outLen)
+        {
+            break;
+        }
+        memcpy(out + used, line, static_cast<size_t>(n));
+        used += static_cast<size_t>(n);
+        cursor = peek;
+    }
+    return used;
+}
+
+size_t HistoryRing::copyBlocks(Cursor &cursor, uint32_t toTime, uint8_t *out, size_t outLen) const
+{
+    if (cursor.block < oldestBlock())
+    {
+        cursor = Cursor();
+        cursor.block = oldestBlock();
+    }
+    size_t used = 0;
+    while (cursor.block < totalBlocks_ && used + BLOCK_BYTES <= outLen)
+    {
+        const Block &b = blockAt(cursor.block);
+        if (b.t0 > toTime)
+        {
+            break;
+        }
+        memcpy(out + used, &b, BLOCK_BYTES);
+        used += BLOCK_BYTES;
+        cursor.block++;
+        cursor.entry = 0;
+    }
+    return used;
+}
@@ -0,0 +1,88 @@
+#ifndef HISTORY_RING_H
+#define HISTORY_RING_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef HISTORY_RING_BLOCKS
+#define HISTORY_RING_BLOCKS 384 // 384 x 64 B = 24 KB, ~7 days at one sample per minute
+#endif
+
+// Fixed-size RAM time series of (time, temperature, relay) samples.
+// Samples are delta-encoded into 64-byte blocks: every block starts with a full key sample
+// (epoch seconds, temperature in 1/16 °C, relay) followed by up to 28 two-byte deltas
+// (dt in seconds, signed 7-bit temperature step + relay bit). A sample that does not fit
+// (gap > 255 s, step > ~4 °C, block full) starts a new block; the oldest block is dropped.
+//
+// Binary export (copyBlocks) is the raw block array, little endian:
+//   uint32 t0 | int16 temp0 (1/16 °C) | uint8 relay0 | uint8 n | n x { uint8 dt, int8 (dtemp << 1 | relay) } | padding
+class HistoryRing
+{
+public:
+    static constexpr size_t BLOCK_BYTES = 64;
+    static constexpr size_t HEADER_BYTES = 8;
+    static constexpr uint8_t DELTAS_PER_BLOCK = (BLOCK_BYTES - HEADER_BYTES) / 2;
+    static constexpr uint32_t MAX_BLOCKS = HISTORY_RING_BLOCKS;
+    static constexpr float TEMP_SCALE = 16.0f;
+
+    struct Sample
+    {
+        uint32_t time;
+        float temperature;
+        bool relay;
+    };
+
+    // Iteration state; stays valid while samples are appended (overwritten blocks are skipped).
+    struct Cursor
+    {
+        uint32_t block = 0; // absolute block number
+        uint8_t entry = 0;  // 0 = key sample, k = k-th delta
+        uint32_t time = 0;
+        int16_t tempQ = 0;
+    };
+
+    // Returns false for samples that are not newer than the last one.
+    bool append(uint32_t time, float temperature, bool relay);
+    void clear();
+
+    uint32_t sampleCount() const { return samples_; }
+    uint32_t blockCount() const { return totalBlocks_ < MAX_BLOCKS ? totalBlocks_ : MAX_BLOCKS; }
+    size_t bytesUsed() const { return blockCount() * BLOCK_BYTES; }
+    uint32_t oldestTime() const;
+    uint32_t newestTime() const { return totalBlocks_ ? lastTime_ : 0; }
+
+    // Cursor at the first sample with time >= fromTime.
+    Cursor seek(uint32_t fromTime) const;
+    // Next sample at the cursor; false when there are no more samples (yet).
+    bool next(Cursor &cursor, Sample &out) const;
+
+    // "time,temp,relay\n" lines up to toTime; returns bytes written (only whole lines).
+    size_t writeCsv(Cursor &cursor, uint32_t toTime, char *out, size_t outLen) const;
+    // Raw blocks from the cursor's block up to the block holding toTime; whole blocks only.
+    size_t copyBlocks(Cursor &cursor, uint32_t toTime, uint8_t *out, size_t outLen) const;
+
+private:
+    struct Block
+    {
+        uint32_t t0;
+        int16_t temp0;
+        uint8_t relay0;
+        uint8_t count;
+        uint8_t deltas[BLOCK_BYTES - HEADER_BYTES];
+    };
+    static_assert(sizeof(Block) == BLOCK_BYTES, "history block must stay 64 bytes");
+
+    uint32_t oldestBlock() const { return totalBlocks_ - blockCount(); }
+    const Block &blockAt(uint32_t absolute) const { return blocks_[absolute % MAX_BLOCKS]; }
+    void startBlock(uint32_t time, int16_t tempQ, bool relay);
+
+    Block blocks_[MAX_BLOCKS] = {};
+    uint32_t totalBlocks_ = 0; // blocks ever started; the newest is totalBlocks_ - 1
+    uint32_t samples_ = 0;     // samples currently held
+    uint32_t lastTime_ = 0;
+    int16_t lastTempQ_ = 0;
+};
+
+#endif // HISTORY_RING_H
@@ -0,0 +1,163 @@
+#include "LoopProfiler.h"
+
+#include <cstdio>
+
+uint8_t LatencyHistogram::bucketIndex(uint32_t value)
+{
+    if (value < 4)
+    {
+        return static_cast<uint8_t>(value);
+    }
+    const uint8_t msb = static_cast<uint8_t>(31 - __builtin_clz(value));
+    const uint8_t sub = static_cast<uint8_t>((value >> (msb - 2)) & 0x3);
+    return static_cast<uint8_t>((msb - 1) * 4 + sub);
+}
+
+uint32_t LatencyHistogram::bucketUpperBound(uint8_t index)
+{
+    if (index < 4)
+    {
+        return index;
+    }
+    const uint8_t msb = static_cast<uint8_t>(index / 4 + 1);
+    const uint32_t sub = index % 4;
+    const uint32_t width = 1UL << (msb - 2);
+    const uint32_t lower = (4 + sub) << (msb - 2);
+    return lower + (width - 1);
+}
+
+void LatencyHistogram::record(uint32_t value)
+{
+    buckets_[bucketIndex(value)]++;
+    count_++;
+    if (value < min_)
+    {
+        min_ = value;
+    }
+    if (value > max_)
+    {
+        max_ = value;
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (uint32_t &b : buckets_)
+    {
+        b = 0;
+    }
+    count_ = 0;
+    min_ = UINT32_MAX;
+    max_ = 0;
+}
+
+uint32_t LatencyHistogram::percentile(float pct) const
+{
+    if (count_ == 0)
+    {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>((pct / 100.0f) * count_ + 0.5f);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (uint8_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += buckets_[i];
+        if (seen >= rank)
+        {
+            const uint32_t upper = bucketUpperBound(i);
+            return upper < max_ ? upper : max_;
+        }
+    }
+    return max_;
+}
+
+LoopProfiler::LoopProfiler(CycleSource source, uint32_t cyclesPerUs)
+    : source_(source), cyclesPerUs_(cyclesPerUs ? cyclesPerUs : 1)
+{
+}
+
+uint8_t LoopProfiler::addStage(const char *name)
+{
+    if (stageCount_ >= MAX_STAGES)
+    {
+        return MAX_STAGES - 1;
+    }
+    names_[stageCount_] = name;
+    return stageCount_++;
+}
+
+const char *LoopProfiler::stageName(uint8_t stage) const
+{
+    return (stage < stageCount_ && names_[stage]) ? names_[stage] : "?";
+}
+
+void LoopProfiler::record(uint8_t stage, uint32_t cycles)
+{
+    if (stage < MAX_STAGES)
+    {
+        histograms_[stage].record(cycles);
+    }
+}
+
+void LoopProfiler::reset()
+{
+    for (LatencyHistogram &h : histograms_)
+    {
+        h.reset();
+    }
+}
+
+uint8_t LoopProfiler::slowestStage(uint8_t exclude) const
+{
+    uint8_t slowest = exclude == 0 && stageCount_ > 1 ? 1 : 0;
+    uint32_t slowestP99 = 0;
+    for (uint8_t i = 0; i < stageCount_; ++i)
+    {
+        const uint32_t p99 = histograms_[i].percentile(99.0f);
+        if (i != exclude && p99 > slowestP99)
+        {
+            slowestP99 = p99;
+            slowest = i;
+        }
+    }
+    return slowest;
+}
+
+size_t LoopProfiler::writeJson(char *out, size_t outLen) const
+{
+    if (!out || outLen == 0)
+    {
+        return 0;
+    }
+
+    size_t used = 0;
+    auto append = [&](int written)
+    {
+        if (written > 0)
+        {
+            used += static_cast<size_t>(written);
+        }
+        if (used >= outLen)
+        {
+            used = outLen - 1;
+        }
+    };
+
+    append(snprintf(out, outLen, "{\"cyclesPerUs\":%lu,\"stages\":[", (unsigned long)cyclesPerUs_));
+    for (uint8_t i = 0; i < stageCount_; ++i)
+    {
+        const LatencyHistogram &h = histograms_[i];
+        append(snprintf(out + used, outLen - used,
+                        "%s{\"name\":\"%s\",\"n\":%lu,\"min\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu}",
+                        i ? "," : "", stageName(i),
+                        (unsigned long)h.count(), (unsigned long)h.min(),
+                        (unsigned long)h.percentile(50.0f), (unsigned long)h.percentile(99.0f),
+                        (unsigned long)h.max()));
+    }
+    append(snprintf(out + used, outLen - used, "]}"));
+    return used;
+}
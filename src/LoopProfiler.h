@@ -0,0 +1,87 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear latency histogram (4 sub-buckets per power of two, <25% bucket error).
+// Fixed size, no allocation; suitable for recording every loop() pass.
+class LatencyHistogram
+{
+public:
+    static constexpr uint8_t BUCKET_COUNT = 124;
+
+    void record(uint32_t value);
+    void reset();
+
+    uint32_t count() const { return count_; }
+    uint32_t min() const { return count_ ? min_ : 0; }
+    uint32_t max() const { return max_; }
+    // Upper bound of the bucket holding the given percentile (0..100), clamped to max().
+    uint32_t percentile(float pct) const;
+
+    static uint8_t bucketIndex(uint32_t value);
+    static uint32_t bucketUpperBound(uint8_t index);
+
+private:
+    uint32_t buckets_[BUCKET_COUNT] = {};
+    uint32_t count_ = 0;
+    uint32_t min_ = UINT32_MAX;
+    uint32_t max_ = 0;
+};
+
+// Per-stage cycle profiler for the main loop.
+// The cycle source is injected so the same code runs on the ESP32 (CPU cycle counter)
+// and on the host (steady clock) in the native benchmarks.
+class LoopProfiler
+{
+public:
+    using CycleSource = uint32_t (*)();
+    static constexpr uint8_t MAX_STAGES = 16;
+
+    class Scope
+    {
+    public:
+        Scope(LoopProfiler &profiler, uint8_t stage) : profiler_(profiler), stage_(stage), start_(profiler.now()) {}
+        ~Scope() { profiler_.record(stage_, profiler_.now() - start_); }
+
+    private:
+        LoopProfiler &profiler_;
+        uint8_t stage_;
+        uint32_t start_;
+    };
+
+    explicit LoopProfiler(CycleSource source, uint32_t cyclesPerUs = 1);
+
+    // Register a stage; returns its id (or MAX_STAGES - 1 when full). Name must outlive the profiler.
+    uint8_t addStage(const char *name);
+    uint8_t stageCount() const { return stageCount_; }
+    const char *stageName(uint8_t stage) const;
+    const LatencyHistogram &histogram(uint8_t stage) const { return histograms_[stage]; }
+
+    void setCyclesPerUs(uint32_t cyclesPerUs) { cyclesPerUs_ = cyclesPerUs ? cyclesPerUs : 1; }
+    uint32_t cyclesPerUs() const { return cyclesPerUs_; }
+    uint32_t toUs(uint32_t cycles) const { return cycles / cyclesPerUs_; }
+
+    uint32_t now() const { return source_(); }
+    void record(uint8_t stage, uint32_t cycles);
+    void reset();
+
+    // Stage with the highest p99 (useful for a one-line summary). `exclude` skips one stage,
+    // e.g. the whole-pass total that would always win.
+    uint8_t slowestStage(uint8_t exclude = MAX_STAGES) const;
+
+    // Compact JSON report; returns the number of chars written (truncated output is still terminated).
+    size_t writeJson(char *out, size_t outLen) const;
+
+private:
+    CycleSource source_;
+    uint32_t cyclesPerUs_;
+    uint8_t stageCount_ = 0;
+    const char *names_[MAX_STAGES] = {};
+    LatencyHistogram histograms_[MAX_STAGES];
+};
+
+#endif // LOOP_PROFILER_H
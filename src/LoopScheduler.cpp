@@ -0,0 +1,143 @@
+#include "LoopScheduler.h"
+
+namespace
+{
+    constexpr uint32_t NO_DEADLINE_MS = 0x7FFFFFFFUL; // msUntilNext() when every task is idle
+}
+
+uint8_t LoopScheduler::add(const char *name, uint32_t intervalMs, Callback callback, uint32_t nowMs)
+{
+    if (taskCount_ >= MAX_TASKS || !callback)
+    {
+        return INVALID_TASK;
+    }
+    const uint8_t id = taskCount_++;
+    Task &task = tasks_[id];
+    task.name = name;
+    task.callback = callback;
+    task.intervalMs = intervalMs;
+    task.dueMs = nowMs;
+    order_[id] = id;
+    return id;
+}
+
+void LoopScheduler::setInterval(uint8_t id, uint32_t intervalMs)
+{
+    if (id < taskCount_)
+    {
+        tasks_[id].intervalMs = intervalMs;
+    }
+}
+
+void LoopScheduler::scheduleAt(uint8_t id, uint32_t dueMs)
+{
+    if (id < taskCount_)
+    {
+        tasks_[id].dueMs = dueMs;
+        tasks_[id].idle = false;
+    }
+}
+
+void LoopScheduler::trigger(uint8_t id)
+{
+    if (id < MAX_TASKS)
+    {
+        triggered_.fetch_or(1UL << id, std::memory_order_relaxed);
+    }
+}
+
+void LoopScheduler::sortByDeadline()
+{
+    // Insertion sort on deadlines relative to sortBaseMs_ (wrap-safe); N is tiny and mostly sorted.
+    for (uint8_t i = 1; i < taskCount_; ++i)
+    {
+        const uint8_t id = order_[i];
+        const uint32_t key = tasks_[id].dueMs - sortBaseMs_;
+        int8_t j = static_cast<int8_t>(i) - 1;
+        while (j >= 0 && static_cast<int32_t>(tasks_[order_[j]].dueMs - sortBaseMs_) > static_cast<int32_t>(key))
+        {
+            order_[j + 1] = order_[j];
+            --j;
+        }
+        order_[j + 1] = id;
+    }
+}
+
+uint8_t LoopScheduler::runDue(uint32_t nowMs)
+{
+    const uint32_t pending = triggered_.exchange(0, std::memory_order_relaxed);
+
+    sortBaseMs_ = nowMs;
+    sortByDeadline();
+
+    uint8_t snapshot[MAX_TASKS];
+    for (uint8_t i = 0; i < taskCount_; ++i)
+    {
+        snapshot[i] = order_[i];
+    }
+
+    uint8_t ran = 0;
+    for (uint8_t i = 0; i < taskCount_; ++i)
+    {
+        const uint8_t id = snapshot[i];
+        Task &task = tasks_[id];
+        const bool due = !task.idle && isDue(task.dueMs, nowMs);
+        if (!due && !(pending & (1UL << id)))
+        {
+            continue;
+        }
+
+        const uint32_t dueBefore = task.dueMs;
+        task.callback();
+        task.runs++;
+        ran++;
+
+        if (!due || task.idle || task.dueMs != dueBefore)
+        {
+            continue; // early trigger keeps its deadline; callback may have rescheduled itself
+        }
+        if (task.intervalMs == 0)
+        {
+            task.idle = true; // run only when triggered/scheduled
+            continue;
+        }
+        task.dueMs = dueBefore + task.intervalMs; // drift-free: anchored to the previous deadline
+        if (isDue(task.dueMs, nowMs))
+        {
+            late_++; // missed at least one full period, resync instead of bursting
+            task.dueMs = nowMs + task.intervalMs;
+        }
+    }
+
+    if (ran)
+    {
+        passes_++;
+    }
+    return ran;
+}
+
+uint32_t LoopScheduler::msUntilNext(uint32_t nowMs) const
+{
+    if (triggered_.load(std::memory_order_relaxed) != 0)
+    {
+        return 0;
+    }
+    uint32_t best = NO_DEADLINE_MS;
+    for (uint8_t i = 0; i < taskCount_; ++i)
+    {
+        if (tasks_[i].idle)
+        {
+            continue;
+        }
+        const int32_t delta = static_cast<int32_t>(tasks_[i].dueMs - nowMs);
+        if (delta <= 0)
+        {
+            return 0;
+        }
+        if (static_cast<uint32_t>(delta) < best)
+        {
+            best = static_cast<uint32_t>(delta);
+        }
+    }
+    return best;
+}
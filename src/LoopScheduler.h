@@ -0,0 +1,64 @@
+#ifndef LOOP_SCHEDULER_H
+#define LOOP_SCHEDULER_H
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Small cooperative scheduler for loop().
+// Tasks run on fixed, drift-free deadlines (next = previous deadline + interval) and can be
+// triggered early from events. The caller sleeps for msUntilNext() between passes.
+class LoopScheduler
+{
+public:
+    using Callback = void (*)();
+    static constexpr uint8_t MAX_TASKS = 16;
+    static constexpr uint8_t INVALID_TASK = 0xFF;
+
+    // Register a task; the first run is due immediately. Name must outlive the scheduler.
+    uint8_t add(const char *name, uint32_t intervalMs, Callback callback, uint32_t nowMs);
+
+    void setInterval(uint8_t id, uint32_t intervalMs);
+    uint32_t interval(uint8_t id) const { return id < taskCount_ ? tasks_[id].intervalMs : 0; }
+    // Override the next deadline (e.g. a sensor that knows when its result is ready); also wakes
+    // an idle zero-interval task.
+    void scheduleAt(uint8_t id, uint32_t dueMs);
+    // Run the task on the next pass. Safe to call from other tasks/ISRs (atomic bit set).
+    void trigger(uint8_t id);
+
+    // Run all due or triggered tasks in deadline order. Returns the number of callbacks run.
+    uint8_t runDue(uint32_t nowMs);
+    // Milliseconds until the earliest deadline (0 = something is due or triggered).
+    uint32_t msUntilNext(uint32_t nowMs) const;
+
+    uint8_t taskCount() const { return taskCount_; }
+    const char *taskName(uint8_t id) const { return id < taskCount_ ? tasks_[id].name : "?"; }
+    uint32_t runCount(uint8_t id) const { return id < taskCount_ ? tasks_[id].runs : 0; }
+    uint32_t passCount() const { return passes_; }
+    uint32_t lateCount() const { return late_; }
+
+private:
+    struct Task
+    {
+        const char *name = nullptr;
+        Callback callback = nullptr;
+        uint32_t intervalMs = 0;
+        uint32_t dueMs = 0;
+        bool idle = false; // interval 0 after its run: skipped until scheduleAt() or trigger()
+        uint32_t runs = 0;
+    };
+
+    static bool isDue(uint32_t dueMs, uint32_t nowMs) { return static_cast<int32_t>(nowMs - dueMs) >= 0; }
+    void sortByDeadline();
+
+    Task tasks_[MAX_TASKS];
+    uint8_t order_[MAX_TASKS] = {}; // task ids sorted by dueMs
+    uint8_t taskCount_ = 0;
+    uint32_t sortBaseMs_ = 0;
+    std::atomic<uint32_t> triggered_{0};
+    uint32_t passes_ = 0;
+    uint32_t late_ = 0;
+};
+
+#endif // LOOP_SCHEDULER_H
@@ -0,0 +1,238 @@
+#include "MqttDispatch.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    inline char lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+    }
+
+    inline bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    bool equalsIgnoreCase(const char *s, unsigned len, const char *lit)
+    {
+        for (unsigned i = 0; i < len; ++i)
+        {
+            if (lit[i] == '\0' || lower(s[i]) != lit[i])
+            {
+                return false;
+            }
+        }
+        return lit[len] == '\0';
+    }
+}
+
+uint32_t MqttDispatcher::hash(const char *s, size_t len)
+{
+    uint32_t h = 2166136261UL; // FNV-1a
+    for (size_t i = 0; i < len; ++i)
+    {
+        h ^= static_cast<uint8_t>(s[i]);
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+void MqttDispatcher::clear()
+{
+    for (Entry &e : slots_)
+    {
+        e = Entry();
+    }
+    count_ = 0;
+    maxProbe_ = 0;
+}
+
+bool MqttDispatcher::add(const char *suffix, PayloadKind kind, MqttHandler handler)
+{
+    if (!suffix || !handler || count_ >= MAX_ENTRIES)
+    {
+        return false;
+    }
+    const size_t len = strlen(suffix);
+    const uint32_t h = hash(suffix, len);
+    for (uint8_t probe = 0; probe < TABLE_SIZE; ++probe)
+    {
+        Entry &e = slots_[(h + probe) & (TABLE_SIZE - 1)];
+        if (e.handler && e.hash == h && e.suffixLen == len && memcmp(e.suffix, suffix, len) == 0)
+        {
+            return false; // duplicate
+        }
+        if (!e.handler)
+        {
+            e.suffix = suffix;
+            e.suffixLen = static_cast<uint16_t>(len);
+            e.hash = h;
+            e.kind = kind;
+            e.handler = handler;
+            count_++;
+            if (probe > maxProbe_)
+            {
+                maxProbe_ = probe;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void MqttDispatcher::setBase(const char *base)
+{
+    base_ = base;
+    baseLen_ = base ? strlen(base) : 0;
+}
+
+bool MqttDispatcher::dispatch(const char *topic, const uint8_t *payload, unsigned length) const
+{
+    if (!topic || !base_ || baseLen_ == 0 || strncmp(topic, base_, baseLen_) != 0)
+    {
+        return false;
+    }
+
+    const char *sfx = topic + baseLen_;
+    const size_t sfxLen = strlen(sfx);
+    const uint32_t h = hash(sfx, sfxLen);
+
+    for (uint8_t probe = 0; probe <= maxProbe_; ++probe)
+    {
+        const Entry &e = slots_[(h + probe) & (TABLE_SIZE - 1)];
+        if (!e.handler)
+        {
+            return false;
+        }
+        if (e.hash != h || e.suffixLen != sfxLen || memcmp(e.suffix, sfx, sfxLen) != 0)
+        {
+            continue;
+        }
+
+        MqttValue value;
+        value.kind = e.kind;
+        trim(payload, length, value.raw, value.rawLen);
+        switch (e.kind)
+        {
+        case PayloadKind::None:
+            value.valid = true;
+            break;
+        case PayloadKind::Bool:
+            value.b = parseBool(value.raw, value.rawLen);
+            value.valid = true;
+            break;
+        case PayloadKind::Int:
+            value.valid = parseInt(value.raw, value.rawLen, value.i);
+            break;
+        case PayloadKind::Float:
+            value.valid = parseFloat(value.raw, value.rawLen, value.f);
+            break;
+        }
+        e.handler(value);
+        return true;
+    }
+    return false;
+}
+
+void MqttDispatcher::trim(const uint8_t *payload, unsigned length, const char *&start, unsigned &len)
+{
+    start = reinterpret_cast<const char *>(payload);
+    len = payload ? length : 0;
+    while (len > 0 && isSpace(start[0]))
+    {
+        start++;
+        len--;
+    }
+    while (len > 0 && isSpace(start[len - 1]))
+    {
+        len--;
+    }
+}
+
+bool MqttDispatcher::parseBool(const char *s, unsigned len)
+{
+    return equalsIgnoreCase(s, len, "1") || equalsIgnoreCase(s, len, "true") || equalsIgnoreCase(s, len, "on");
+}
+
+bool MqttDispatcher::parseInt(const char *s, unsigned len, long &out)
+{
+    out = 0;
+    unsigned i = 0;
+    bool negative = false;
+    if (i < len && (s[i] == '-' || s[i] == '+'))
+    {
+        negative = s[i] == '-';
+        i++;
+    }
+    const unsigned digitsStart = i;
+    long value = 0;
+    while (i < len && isDigit(s[i]))
+    {
+        if (value < 100000000L) // clamp, payloads are minutes / small counts
+        {
+            value = value * 10 + (s[i] - '0');
+        }
+        i++;
+    }
+    if (i == digitsStart)
+    {
+        return false; // "null", "NaN", "" ...
+    }
+    out = negative ? -value : value;
+    return true;
+}
+
+bool MqttDispatcher::parseFloat(const char *s, unsigned len, float &out)
+{
+    out = 0.0f;
+    unsigned i = 0;
+    bool negative = false;
+    if (i < len && (s[i] == '-' || s[i] == '+'))
+    {
+        negative = s[i] == '-';
+        i++;
+    }
+
+    double value = 0.0;
+    bool anyDigit = false;
+    while (i < len && isDigit(s[i]))
+    {
+        value = value * 10.0 + (s[i] - '0');
+        anyDigit = true;
+        i++;
+    }
+    if (i < len && (s[i] == '.' || s[i] == ','))
+    {
+        i++;
+        double scale = 0.1;
+        while (i < len && isDigit(s[i]))
+        {
+            value += (s[i] - '0') * scale;
+            scale *= 0.1;
+            anyDigit = true;
+            i++;
+        }
+    }
+    if (!anyDigit)
+    {
+        return false;
+    }
+    if (i < len && (s[i] == 'e' || s[i] == 'E'))
+    {
+        long exponent = 0;
+        if (parseInt(s + i + 1, len - i - 1, exponent) && exponent > -38 && exponent < 38)
+        {
+            value *= std::pow(10.0, static_cast<double>(exponent));
+        }
+    }
+
+    out = static_cast<float>(negative ? -value : value);
+    return std::isfinite(out);
+}
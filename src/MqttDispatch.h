@@ -0,0 +1,77 @@
+#ifndef MQTT_DISPATCH_H
+#define MQTT_DISPATCH_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Inbound MQTT dispatch.
+// Topics are matched by an FNV-1a hash of their suffix (the part after the base topic) in a
+// small open-addressing table that is built once. Payloads are parsed in place from the raw
+// (payload, length) span - no String copy, no trimming allocations.
+
+enum class PayloadKind : uint8_t
+{
+    None,  // payload ignored (e.g. Save)
+    Bool,  // "1" / "true" / "on" (case-insensitive) -> true, anything else -> false
+    Int,   // leading integer, like atol()
+    Float, // decimal with optional exponent; NaN/Infinity rejected
+};
+
+struct MqttValue
+{
+    PayloadKind kind = PayloadKind::None;
+    bool valid = false; // false when the payload could not be parsed as kind
+    bool b = false;
+    long i = 0;
+    float f = 0.0f;
+    const char *raw = nullptr; // trimmed payload (not NUL terminated)
+    unsigned rawLen = 0;
+};
+
+using MqttHandler = void (*)(const MqttValue &value);
+
+class MqttDispatcher
+{
+public:
+    static constexpr uint8_t TABLE_SIZE = 64; // power of two, > 2x entries
+    static constexpr uint8_t MAX_ENTRIES = 24;
+
+    // Suffix must outlive the dispatcher (string literal / MqttTopicTable::suffix()).
+    bool add(const char *suffix, PayloadKind kind, MqttHandler handler);
+    void clear();
+
+    // Base topic the suffixes are relative to (not copied).
+    void setBase(const char *base);
+
+    // Returns false when the topic is not handled.
+    bool dispatch(const char *topic, const uint8_t *payload, unsigned length) const;
+
+    uint8_t size() const { return count_; }
+    uint8_t maxProbe() const { return maxProbe_; }
+
+    static uint32_t hash(const char *s, size_t len);
+    static void trim(const uint8_t *payload, unsigned length, const char *&start, unsigned &len);
+    static bool parseBool(const char *s, unsigned len);
+    static bool parseInt(const char *s, unsigned len, long &out);
+    static bool parseFloat(const char *s, unsigned len, float &out);
+
+private:
+    struct Entry
+    {
+        const char *suffix = nullptr;
+        uint16_t suffixLen = 0;
+        uint32_t hash = 0;
+        PayloadKind kind = PayloadKind::None;
+        MqttHandler handler = nullptr;
+    };
+
+    Entry slots_[TABLE_SIZE];
+    uint8_t count_ = 0;
+    uint8_t maxProbe_ = 0;
+    const char *base_ = nullptr;
+    size_t baseLen_ = 0;
+};
+
+#endif // MQTT_DISPATCH_H
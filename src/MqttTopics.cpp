@@ -0,0 +1,82 @@
+#include "MqttTopics.h"
+
+#include <cstring>
+
+namespace
+{
+    // Index == MqttTopic value
+    const char *const TOPIC_SUFFIXES[MqttTopicTable::COUNT] = {
+        "/ActualState",
+        "/TemperatureBoiler",
+        "/TimeRemaining",
+        "/YouCanShowerNow",
+        "/State",
+        "/TimeToTarget",
+        "/TemperatureBoilerRaw",
+        "/Settings/SetShowerTime",
+        "/Settings/WillShower",
+        "/Settings/Save",
+        "/Settings/BoilerEnabled",
+        "/Settings/OnThreshold",
+        "/Settings/OffThreshold",
+        "/Settings/BoilerTimeMin",
+        "/Settings/StopTimerOnTarget",
+        "/Settings/OncePerPeriod",
+        "/Settings/YouCanShowerPeriodMin",
+    };
+}
+
+const char *MqttTopicTable::suffix(MqttTopic topic)
+{
+    const uint8_t idx = static_cast<uint8_t>(topic);
+    return idx < COUNT ? TOPIC_SUFFIXES[idx] : "";
+}
+
+bool MqttTopicTable::hasBase(const char *base) const
+{
+    return ready_ && base && strcmp(arena_, base) == 0;
+}
+
+bool MqttTopicTable::build(const char *base)
+{
+    ready_ = false;
+    used_ = 0;
+    arena_[0] = '\0';
+
+    const size_t baseLen = base ? strlen(base) : 0;
+    if (baseLen == 0 || baseLen > MAX_BASE_LEN)
+    {
+        return false;
+    }
+
+    // Layout: "<base>\0<base>/ActualState\0<base>/TemperatureBoiler\0..."
+    memcpy(arena_, base, baseLen + 1);
+    size_t pos = baseLen + 1;
+    for (uint8_t i = 0; i < COUNT; ++i)
+    {
+        const size_t sfxLen = strlen(TOPIC_SUFFIXES[i]);
+        if (pos + baseLen + sfxLen + 1 > ARENA_SIZE)
+        {
+            arena_[0] = '\0';
+            return false;
+        }
+        offsets_[i] = static_cast<uint16_t>(pos);
+        memcpy(arena_ + pos, base, baseLen);
+        memcpy(arena_ + pos + baseLen, TOPIC_SUFFIXES[i], sfxLen + 1);
+        pos += baseLen + sfxLen + 1;
+    }
+
+    used_ = pos;
+    ready_ = true;
+    return true;
+}
+
+const char *MqttTopicTable::get(MqttTopic topic) const
+{
+    const uint8_t idx = static_cast<uint8_t>(topic);
+    if (!ready_ || idx >= COUNT)
+    {
+        return "";
+    }
+    return arena_ + offsets_[idx];
+}
@@ -0,0 +1,60 @@
+#ifndef MQTT_TOPICS_H
+#define MQTT_TOPICS_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// All MQTT topics used by the firmware.
+enum class MqttTopic : uint8_t
+{
+    // state (published)
+    ActualState,
+    TemperatureBoiler,
+    TimeRemaining,
+    YouCanShowerNow,
+    State,        // optional JSON snapshot of the state topics
+    TimeToTarget, // predicted seconds of heating until offThreshold (-1 = not learned yet)
+    TemperatureBoilerRaw, // unfiltered control temperature (offset applied), to compare filter latency
+    // <base>/Settings/... (inbound commands, settings mirrored back retained)
+    SetShowerTime,
+    WillShower,
+    Save,
+    BoilerEnabled,
+    OnThreshold,
+    OffThreshold,
+    BoilerTimeMin,
+    StopTimerOnTarget,
+    OncePerPeriod,
+    YouCanShowerPeriodMin,
+    Count,
+};
+
+// Fixed-capacity topic table. All full topic strings live in one static arena that is
+// rebuilt only when the base topic changes, so publish/dispatch never touch the heap.
+class MqttTopicTable
+{
+public:
+    static constexpr uint8_t COUNT = static_cast<uint8_t>(MqttTopic::Count);
+    static constexpr size_t MAX_BASE_LEN = 64;
+    static constexpr size_t ARENA_SIZE = 1536; // fits MAX_BASE_LEN for every topic
+
+    // Returns false (and leaves the table empty) when base is empty or too long.
+    bool build(const char *base);
+    bool ready() const { return ready_; }
+    bool hasBase(const char *base) const;
+
+    const char *base() const { return arena_; }
+    const char *get(MqttTopic topic) const;
+    static const char *suffix(MqttTopic topic);
+    size_t bytesUsed() const { return used_; }
+
+private:
+    char arena_[ARENA_SIZE] = {};
+    uint16_t offsets_[COUNT] = {};
+    size_t used_ = 0;
+    bool ready_ = false;
+};
+
+#endif // MQTT_TOPICS_H
@@ -0,0 +1,103 @@
+#include "PersistTracker.h"
+
+PersistTracker::PersistTracker(uint8_t keyCount, uint32_t debounceMs, uint32_t maxDelayMs)
+    : keyCount_(keyCount > MAX_KEYS ? MAX_KEYS : keyCount), debounceMs_(debounceMs), maxDelayMs_(maxDelayMs)
+{
+}
+
+void PersistTracker::setStored(uint8_t key, uint32_t fingerprint)
+{
+    if (key >= keyCount_)
+    {
+        return;
+    }
+    stored_[key] = fingerprint;
+    current_[key] = fingerprint;
+    dirty_ &= ~(1u << key);
+    unknown_ &= ~(1u << key);
+}
+
+void PersistTracker::forgetStored(uint8_t key)
+{
+    if (key >= keyCount_)
+    {
+        return;
+    }
+    unknown_ |= 1u << key;
+    dirty_ |= 1u << key;
+}
+
+void PersistTracker::update(uint8_t key, uint32_t fingerprint, uint32_t nowMs)
+{
+    if (key >= keyCount_ || fingerprint == current_[key])
+    {
+        return;
+    }
+    current_[key] = fingerprint;
+    if (fingerprint == stored_[key] && !(unknown_ & (1u << key)))
+    {
+        dirty_ &= ~(1u << key); // changed back: nothing to write
+    }
+    else
+    {
+        dirty_ |= 1u << key;
+    }
+    lastActivityMs_ = nowMs;
+}
+
+void PersistTracker::requestFlush(uint32_t nowMs)
+{
+    if (flushRequested_)
+    {
+        avoided_ += keyCount_; // merged into the pending flush instead of a full rewrite
+    }
+    else
+    {
+        flushRequested_ = true;
+        firstRequestMs_ = nowMs;
+    }
+    lastActivityMs_ = nowMs;
+}
+
+uint32_t PersistTracker::deadlineMs() const
+{
+    const uint32_t debounced = lastActivityMs_ + debounceMs_;
+    const uint32_t capped = firstRequestMs_ + maxDelayMs_;
+    return static_cast<int32_t>(capped - debounced) < 0 ? capped : debounced;
+}
+
+uint32_t PersistTracker::nextDueMs(uint32_t nowMs) const
+{
+    if (!flushRequested_)
+    {
+        return UINT32_MAX;
+    }
+    const uint32_t due = deadlineMs();
+    return static_cast<int32_t>(nowMs - due) >= 0 ? nowMs : due;
+}
+
+uint32_t PersistTracker::takeDue(uint32_t nowMs)
+{
+    if (!flushRequested_ || static_cast<int32_t>(nowMs - deadlineMs()) < 0)
+    {
+        return 0;
+    }
+    flushRequested_ = false;
+    flushes_++;
+
+    const uint32_t mask = dirty_;
+    uint8_t written = 0;
+    for (uint8_t k = 0; k < keyCount_; ++k)
+    {
+        if (mask & (1u << k))
+        {
+            stored_[k] = current_[k];
+            written++;
+        }
+    }
+    dirty_ = 0;
+    unknown_ = 0;
+    writes_ += written;
+    avoided_ += keyCount_ - written;
+    return mask;
+}
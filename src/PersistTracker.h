@@ -0,0 +1,60 @@
+#ifndef PERSIST_TRACKER_H
+#define PERSIST_TRACKER_H
+
+#pragma once
+
+#include <cstdint>
+
+// Dirty tracking and debouncing for settings persistence (no Arduino dependencies).
+// Each key is identified by an index and a 32-bit fingerprint of its value. A key is dirty
+// while its fingerprint differs from the one last written, so a value that is changed and then
+// changed back costs nothing. requestFlush() (the "save" command) starts a debounce window;
+// further changes or requests extend it up to maxDelayMs, then takeDue() hands out the dirty
+// keys once. writesAvoided() counts the key writes a full rewrite per save request would have
+// done on top of that.
+class PersistTracker
+{
+public:
+    static constexpr uint8_t MAX_KEYS = 16;
+
+    PersistTracker(uint8_t keyCount, uint32_t debounceMs, uint32_t maxDelayMs);
+
+    // Fingerprint of the value currently in flash (boot, after load or a full save).
+    void setStored(uint8_t key, uint32_t fingerprint);
+    // Flash was written behind the tracker's back (e.g. a web UI save): the stored fingerprint is
+    // no longer trusted and the key is written on the next flush, whatever its value.
+    void forgetStored(uint8_t key);
+    // Fingerprint of the value currently in RAM.
+    void update(uint8_t key, uint32_t fingerprint, uint32_t nowMs);
+    void requestFlush(uint32_t nowMs);
+
+    // Keys to write now (bit mask), 0 while debouncing or clean. Marks them stored.
+    uint32_t takeDue(uint32_t nowMs);
+    // Next time takeDue() may return something, UINT32_MAX when idle.
+    uint32_t nextDueMs(uint32_t nowMs) const;
+
+    uint32_t dirtyMask() const { return dirty_; }
+    bool flushPending() const { return flushRequested_; }
+    uint32_t keyWrites() const { return writes_; }
+    uint32_t writesAvoided() const { return avoided_; }
+    uint32_t flushes() const { return flushes_; }
+
+private:
+    uint32_t deadlineMs() const;
+
+    uint32_t stored_[MAX_KEYS] = {};
+    uint32_t current_[MAX_KEYS] = {};
+    uint8_t keyCount_;
+    uint32_t debounceMs_;
+    uint32_t maxDelayMs_;
+    uint32_t dirty_ = 0;
+    uint32_t unknown_ = 0; // keys whose flash content is not known
+    bool flushRequested_ = false;
+    uint32_t firstRequestMs_ = 0;
+    uint32_t lastActivityMs_ = 0;
+    uint32_t writes_ = 0;
+    uint32_t avoided_ = 0;
+    uint32_t flushes_ = 0;
+};
+
+#endif // PERSIST_TRACKER_H
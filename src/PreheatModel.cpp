@@ -0,0 +1,59 @@
+#include "PreheatModel.h"
+
+void PreheatModel::reset()
+{
+    *this = PreheatModel();
+}
+
+void PreheatModel::addSession(float startTempC, float heatMinutes)
+{
+    if (heatMinutes < 0.0f)
+    {
+        return;
+    }
+    weight_ = weight_ * FORGET + 1.0f;
+    sumX_ = sumX_ * FORGET + startTempC;
+    sumY_ = sumY_ * FORGET + heatMinutes;
+    sumXX_ = sumXX_ * FORGET + startTempC * startTempC;
+    sumXY_ = sumXY_ * FORGET + startTempC * heatMinutes;
+    if (sessions_ < UINT16_MAX)
+    {
+        sessions_++;
+    }
+}
+
+float PreheatModel::slope() const
+{
+    if (weight_ <= 0.0f)
+    {
+        return 0.0f;
+    }
+    const float meanX = sumX_ / weight_;
+    const float varX = sumXX_ / weight_ - meanX * meanX;
+    if (varX < MIN_SPREAD_C * MIN_SPREAD_C / 4.0f)
+    {
+        return 0.0f; // all sessions started at about the same temperature: use the mean duration
+    }
+    const float covXY = sumXY_ / weight_ - meanX * (sumY_ / weight_);
+    const float b = covXY / varX;
+    return b < 0.0f ? b : 0.0f; // a warmer start never takes longer
+}
+
+float PreheatModel::intercept() const
+{
+    if (weight_ <= 0.0f)
+    {
+        return 0.0f;
+    }
+    return sumY_ / weight_ - slope() * (sumX_ / weight_);
+}
+
+float PreheatModel::estimateMinutes(float startTempC) const
+{
+    if (!known())
+    {
+        return -1.0f;
+    }
+    const float minutes = intercept() + slope() * startTempC;
+    return minutes > 0.0f ? minutes : 0.0f;
+}
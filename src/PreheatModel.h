@@ -0,0 +1,38 @@
+#ifndef PREHEAT_MODEL_H
+#define PREHEAT_MODEL_H
+
+#pragma once
+
+#include <cstdint>
+
+// Heat-up duration as a linear function of the starting temperature, fitted by weighted least
+// squares over past heating sessions (no Arduino dependencies). Each new session scales the
+// weight of the older ones by FORGET, so the fit follows seasonal changes (inlet water, losses).
+class PreheatModel
+{
+public:
+    static constexpr float FORGET = 0.95f;
+    static constexpr uint8_t MIN_SESSIONS = 3;
+    static constexpr float MIN_SPREAD_C = 2.0f; // below this start-temperature spread the slope is not trusted
+
+    void reset();
+    // One session that reached the target after heatMinutes, starting at startTempC.
+    void addSession(float startTempC, float heatMinutes);
+
+    bool known() const { return sessions_ >= MIN_SESSIONS; }
+    uint16_t sessions() const { return sessions_; }
+    // Predicted heat-up minutes from startTempC (>= 0), -1 while unknown.
+    float estimateMinutes(float startTempC) const;
+    float slope() const;     // minutes per °C of starting temperature (usually negative)
+    float intercept() const; // minutes at 0 °C
+
+private:
+    float weight_ = 0.0f;
+    float sumX_ = 0.0f;
+    float sumY_ = 0.0f;
+    float sumXX_ = 0.0f;
+    float sumXY_ = 0.0f;
+    uint16_t sessions_ = 0;
+};
+
+#endif // PREHEAT_MODEL_H
@@ -0,0 +1,84 @@
+#include "PublishCache.h"
+
+#include <cmath>
+
+void PublishCache::configure(uint8_t slot, float deadband, uint32_t maxSilenceMs)
+{
+    if (slot < MAX_SLOTS)
+    {
+        slots_[slot].deadband = deadband > 0.0f ? deadband : 0.0f;
+        slots_[slot].maxSilenceMs = maxSilenceMs;
+    }
+}
+
+void PublishCache::setDeadband(uint8_t slot, float deadband)
+{
+    if (slot < MAX_SLOTS)
+    {
+        slots_[slot].deadband = deadband > 0.0f ? deadband : 0.0f;
+    }
+}
+
+void PublishCache::setMaxSilence(uint32_t maxSilenceMs)
+{
+    for (Slot &s : slots_)
+    {
+        s.maxSilenceMs = maxSilenceMs;
+    }
+}
+
+bool PublishCache::due(uint8_t slot, float value, uint32_t nowMs) const
+{
+    if (slot >= MAX_SLOTS)
+    {
+        return false;
+    }
+    const Slot &s = slots_[slot];
+    if (!s.published)
+    {
+        return true;
+    }
+    if (s.maxSilenceMs > 0 && nowMs - s.lastMs >= s.maxSilenceMs)
+    {
+        return true;
+    }
+    if (value == s.value)
+    {
+        return false;
+    }
+    if ((value == 0.0f) != (s.value == 0.0f))
+    {
+        return true; // e.g. timer ran out, relay switched
+    }
+    return s.deadband <= 0.0f || std::fabs(value - s.value) >= s.deadband;
+}
+
+void PublishCache::markPublished(uint8_t slot, float value, uint32_t nowMs)
+{
+    if (slot < MAX_SLOTS)
+    {
+        slots_[slot].value = value;
+        slots_[slot].lastMs = nowMs;
+        slots_[slot].published = true;
+    }
+}
+
+bool PublishCache::offer(uint8_t slot, float value, uint32_t nowMs)
+{
+    if (!due(slot, value, nowMs))
+    {
+        suppressed_++;
+        return false;
+    }
+    markPublished(slot, value, nowMs);
+    sent_++;
+    return true;
+}
+
+void PublishCache::invalidate()
+{
+    for (Slot &s : slots_)
+    {
+        s.published = false;
+    }
+}
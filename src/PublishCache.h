@@ -0,0 +1,48 @@
+#ifndef PUBLISH_CACHE_H
+#define PUBLISH_CACHE_H
+
+#pragma once
+
+#include <cstdint>
+
+// Per-topic "last published" cache for change-driven MQTT publishing.
+// A slot is due when it was never published, when its value moved by at least the slot's
+// deadband (deadband 0 = any change; changes to/from exactly 0 always count), or when it has
+// been silent for the max-silence heartbeat.
+class PublishCache
+{
+public:
+    static constexpr uint8_t MAX_SLOTS = 8;
+
+    void configure(uint8_t slot, float deadband, uint32_t maxSilenceMs);
+    void setDeadband(uint8_t slot, float deadband);
+    void setMaxSilence(uint32_t maxSilenceMs); // all slots; 0 = no heartbeat
+
+    bool due(uint8_t slot, float value, uint32_t nowMs) const;
+    void markPublished(uint8_t slot, float value, uint32_t nowMs);
+    // due() + markPublished(); counts sent/suppressed.
+    bool offer(uint8_t slot, float value, uint32_t nowMs);
+
+    // Forget everything (reconnect, base topic change) so the next pass republishes all slots.
+    void invalidate();
+
+    float lastValue(uint8_t slot) const { return slot < MAX_SLOTS ? slots_[slot].value : 0.0f; }
+    uint32_t sentCount() const { return sent_; }
+    uint32_t suppressedCount() const { return suppressed_; }
+
+private:
+    struct Slot
+    {
+        float value = 0.0f;
+        float deadband = 0.0f;
+        uint32_t maxSilenceMs = 0;
+        uint32_t lastMs = 0;
+        bool published = false;
+    };
+
+    Slot slots_[MAX_SLOTS];
+    uint32_t sent_ = 0;
+    uint32_t suppressed_ = 0;
+};
+
+#endif // PUBLISH_CACHE_H
@@ -0,0 +1,85 @@
+#include "SensorModeStats.h"
+
+#include <cmath>
+
+uint8_t SensorModeStats::normalizeBits(int bits)
+{
+    if (bits < MIN_BITS)
+    {
+        return MIN_BITS;
+    }
+    return bits > MAX_BITS ? MAX_BITS : static_cast<uint8_t>(bits);
+}
+
+uint8_t SensorModeStats::normalizeOversample(int oversample)
+{
+    uint8_t os = 1;
+    while (os < MAX_OVERSAMPLE && os * 2 <= oversample)
+    {
+        os *= 2;
+    }
+    return os;
+}
+
+uint8_t SensorModeStats::indexOf(uint8_t bits, uint8_t oversample)
+{
+    uint8_t step = 0;
+    while (step + 1 < OVERSAMPLE_STEPS && (1u << (step + 1)) <= oversample)
+    {
+        step++;
+    }
+    return static_cast<uint8_t>((normalizeBits(bits) - MIN_BITS) * OVERSAMPLE_STEPS + step);
+}
+
+void SensorModeStats::select(uint8_t bits, uint8_t oversample)
+{
+    bits_ = normalizeBits(bits);
+    oversample_ = normalizeOversample(oversample);
+    chain_ = 0;
+}
+
+void SensorModeStats::addFault()
+{
+    chain_ = 0;
+}
+
+void SensorModeStats::addSample(uint32_t sampleMs, float valueC)
+{
+    const uint8_t index = indexOf(bits_, oversample_);
+    Accumulator &a = acc_[index];
+    a.weight = a.weight * FORGET + 1.0f;
+    a.sumMs = a.sumMs * FORGET + static_cast<float>(sampleMs);
+
+    if (chain_ == 2)
+    {
+        const float d2 = valueC - 2.0f * prev_[1] + prev_[0];
+        a.noiseWeight = a.noiseWeight * FORGET + 1.0f;
+        a.sumD2Sq = a.sumD2Sq * FORGET + d2 * d2;
+    }
+    prev_[0] = prev_[1];
+    prev_[1] = valueC;
+    if (chain_ < 2)
+    {
+        chain_++;
+    }
+
+    entries_[index].samples++;
+    refresh(index);
+}
+
+void SensorModeStats::refresh(uint8_t index)
+{
+    const Accumulator &a = acc_[index];
+    Entry &e = entries_[index];
+    e.sampleMs = a.weight > 0.0f ? a.sumMs / a.weight : 0.0f;
+
+    const uint8_t bits = static_cast<uint8_t>(MIN_BITS + index / OVERSAMPLE_STEPS);
+    const float lsb = lsbC(bits);
+    const float measuredVar = a.noiseWeight > 0.0f ? a.sumD2Sq / a.noiseWeight / 6.0f : 0.0f;
+    e.noiseC = std::sqrt(measuredVar + lsb * lsb / 12.0f);
+}
+
+const SensorModeStats::Entry &SensorModeStats::stats(uint8_t bits, uint8_t oversample) const
+{
+    return entries_[indexOf(bits, oversample)];
+}
@@ -0,0 +1,67 @@
+#ifndef SENSOR_MODE_STATS_H
+#define SENSOR_MODE_STATS_H
+
+#pragma once
+
+#include <cstdint>
+
+// Per-mode timing and noise bookkeeping for the DS18B20 read modes (no Arduino dependencies).
+// A mode is a resolution (9..12 bit) plus an oversampling factor (1, 2, 4 or 8 conversions
+// averaged into one sample). Noise is estimated from the second difference of consecutive
+// samples, which cancels a linear heating/cooling trend: var(noise) = E[d2^2] / 6. The
+// quantisation error of the resolution (LSB^2 / 12) is added, because averaging a steady
+// signal without dither does not remove it.
+class SensorModeStats
+{
+public:
+    static constexpr uint8_t MIN_BITS = 9;
+    static constexpr uint8_t MAX_BITS = 12;
+    static constexpr uint8_t OVERSAMPLE_STEPS = 4; // 1, 2, 4, 8
+    static constexpr uint8_t MAX_OVERSAMPLE = 8;
+    static constexpr uint8_t MODE_COUNT = (MAX_BITS - MIN_BITS + 1) * OVERSAMPLE_STEPS;
+    static constexpr float FORGET = 0.97f;
+
+    struct Entry
+    {
+        uint32_t samples = 0;
+        float sampleMs = 0.0f; // average time per averaged sample (all conversions)
+        float noiseC = 0.0f;   // 1-sigma noise estimate incl. quantisation
+    };
+
+    // Clamp to the supported range (oversampling rounded down to a power of two).
+    static uint8_t normalizeBits(int bits);
+    static uint8_t normalizeOversample(int oversample);
+    static float lsbC(uint8_t bits) { return 0.5f / static_cast<float>(1u << (bits - MIN_BITS)); }
+
+    // Switch the active mode; breaks the difference chain but keeps every mode's history.
+    void select(uint8_t bits, uint8_t oversample);
+    uint8_t bits() const { return bits_; }
+    uint8_t oversample() const { return oversample_; }
+
+    void addSample(uint32_t sampleMs, float valueC);
+    void addFault(); // a missing sample: the next differences restart
+
+    const Entry &stats(uint8_t bits, uint8_t oversample) const;
+    const Entry &current() const { return stats(bits_, oversample_); }
+
+private:
+    struct Accumulator
+    {
+        float weight = 0.0f;
+        float sumMs = 0.0f;
+        float noiseWeight = 0.0f;
+        float sumD2Sq = 0.0f;
+    };
+
+    static uint8_t indexOf(uint8_t bits, uint8_t oversample);
+    void refresh(uint8_t index);
+
+    Accumulator acc_[MODE_COUNT];
+    Entry entries_[MODE_COUNT];
+    uint8_t bits_ = MAX_BITS;
+    uint8_t oversample_ = 1;
+    float prev_[2] = {};
+    uint8_t chain_ = 0; // consecutive samples in prev_
+};
+
+#endif // SENSOR_MODE_STATS_H
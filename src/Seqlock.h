@@ -0,0 +1,89 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// Single-writer, multi-reader shared value without locks. The value is double-buffered: the
+// writer fills the slot readers are not pointed at (bumping that slot's sequence counter to odd
+// and back to even around the copy) and then flips the published index, so store() never waits.
+// A reader copies the published slot and keeps the copy only if the slot's counter was even and
+// unchanged around it; otherwise it retries a bounded number of times. Reads therefore never see
+// a half-written value, and there is no mutex on either side. A reader that preempted the writer
+// mid-store on the same core still reads the other, complete slot at once, so it neither spins
+// on a writer that cannot run nor needs a private last-good copy; a retry needs the writer to
+// finish two stores during one copy.
+// T must be trivially copyable and small (the copy is the critical section).
+template <typename T>
+class Seqlock
+{
+public:
+    static constexpr uint8_t MAX_READ_TRIES = 16;
+
+    // Writer side (one task only).
+    void store(const T &value)
+    {
+        const uint32_t version = version_.load(std::memory_order_relaxed);
+        Slot &slot = slots_[(version + 1) & 1U];
+        const uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&slot.value, &value, sizeof(T));
+        slot.seq.store(seq + 2, std::memory_order_release);
+        version_.store(version + 1, std::memory_order_release);
+    }
+
+    // Reader side, any task. Returns false only when the writer overtook every attempt; out then
+    // keeps its previous content.
+    bool tryLoad(T &out) const
+    {
+        for (uint8_t attempt = 0; attempt < MAX_READ_TRIES; ++attempt)
+        {
+            const Slot &slot = slots_[version_.load(std::memory_order_acquire) & 1U];
+            const uint32_t before = slot.seq.load(std::memory_order_acquire);
+            if (before & 1U)
+            {
+                retries_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            T copy;
+            memcpy(&copy, &slot.value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == before)
+            {
+                out = copy;
+                return true;
+            }
+            retries_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    // Newest value, or `fallback` when tryLoad() gave up.
+    T load(const T &fallback) const
+    {
+        T out = fallback;
+        tryLoad(out);
+        return out;
+    }
+
+    // Number of completed stores; a cheap "did anything change" check for pollers.
+    uint32_t version() const { return version_.load(std::memory_order_acquire); }
+    uint32_t readRetries() const { return retries_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> seq{0};
+        T value = {};
+    };
+
+    std::atomic<uint32_t> version_{0}; // low bit selects the published slot
+    Slot slots_[2];
+    mutable std::atomic<uint32_t> retries_{0};
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,268 @@
+#include "SessionLog.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr float TEMP_SCALE = 16.0f;
+    constexpr uint8_t MAX_LISTED = 16; // tolerate a few stray segments left by an interrupted rotation
+
+    uint8_t crc8(const uint8_t *data, size_t len)
+    {
+        uint8_t crc = 0;
+        for (size_t i = 0; i < len; ++i)
+        {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    int16_t quantize(float temperature)
+    {
+        const long q = lroundf(temperature * TEMP_SCALE);
+        return static_cast<int16_t>(q < INT16_MIN ? INT16_MIN : (q > INT16_MAX ? INT16_MAX : q));
+    }
+
+    void put16(uint8_t *out, uint16_t v)
+    {
+        out[0] = static_cast<uint8_t>(v);
+        out[1] = static_cast<uint8_t>(v >> 8);
+    }
+
+    void put32(uint8_t *out, uint32_t v)
+    {
+        put16(out, static_cast<uint16_t>(v));
+        put16(out + 2, static_cast<uint16_t>(v >> 16));
+    }
+
+    uint16_t get16(const uint8_t *in) { return static_cast<uint16_t>(in[0] | (in[1] << 8)); }
+    uint32_t get32(const uint8_t *in) { return get16(in) | (static_cast<uint32_t>(get16(in + 2)) << 16); }
+}
+
+void SessionLog::encode(const SessionRecord &record, uint8_t *out)
+{
+    const uint32_t durationMin = record.endTime > record.startTime ? (record.endTime - record.startTime + 30) / 60 : 0;
+    put32(out, record.startTime);
+    put16(out + 4, static_cast<uint16_t>(durationMin > UINT16_MAX ? UINT16_MAX : durationMin));
+    put16(out + 6, record.onMinutes);
+    put16(out + 8, record.heatMinutes);
+    put16(out + 10, static_cast<uint16_t>(quantize(record.startTemp)));
+    put16(out + 12, static_cast<uint16_t>(quantize(record.endTemp)));
+    out[14] = record.reason;
+    out[15] = crc8(out, RECORD_BYTES - 1);
+}
+
+bool SessionLog::decode(const uint8_t *in, SessionRecord &out)
+{
+    if (crc8(in, RECORD_BYTES - 1) != in[15])
+    {
+        return false;
+    }
+    out.startTime = get32(in);
+    out.endTime = out.startTime + get16(in + 4) * 60UL;
+    out.onMinutes = get16(in + 6);
+    out.heatMinutes = get16(in + 8);
+    out.startTemp = static_cast<int16_t>(get16(in + 10)) / TEMP_SCALE;
+    out.endTemp = static_cast<int16_t>(get16(in + 12)) / TEMP_SCALE;
+    out.reason = in[14];
+    return true;
+}
+
+uint32_t SessionLog::begin()
+{
+    uint32_t ids[MAX_LISTED];
+    uint8_t count = storage_.listSegments(ids, MAX_LISTED);
+
+    // Insertion sort, oldest id first
+    for (uint8_t i = 1; i < count; ++i)
+    {
+        const uint32_t id = ids[i];
+        int8_t j = static_cast<int8_t>(i) - 1;
+        while (j >= 0 && ids[j] > id)
+        {
+            ids[j + 1] = ids[j];
+            --j;
+        }
+        ids[j + 1] = id;
+    }
+
+    uint8_t first = 0;
+    while (count - first > MAX_SEGMENTS)
+    {
+        storage_.remove(ids[first++]);
+    }
+
+    segmentCount_ = 0;
+    stored_ = 0;
+    size_t tailBytes = 0;
+    for (uint8_t i = first; i < count; ++i)
+    {
+        tailBytes = storage_.segmentSize(ids[i]);
+        segmentIds_[segmentCount_] = ids[i];
+        segmentRecords_[segmentCount_] = static_cast<uint32_t>(tailBytes / RECORD_BYTES);
+        stored_ += segmentRecords_[segmentCount_];
+        segmentCount_++;
+    }
+    // A torn tail (interrupted write) would misalign later records; continue in a fresh segment.
+    tailWritable_ = segmentCount_ > 0 && (tailBytes % RECORD_BYTES) == 0;
+    return stored_;
+}
+
+bool SessionLog::append(const SessionRecord &record, uint32_t nowMs)
+{
+    if (pending_ >= RECORDS_PER_PAGE && !writePending())
+    {
+        return false;
+    }
+    if (pending_ == 0)
+    {
+        pendingSinceMs_ = nowMs;
+    }
+    encode(record, page_ + pending_ * RECORD_BYTES);
+    pending_++;
+    return pending_ < RECORDS_PER_PAGE || writePending();
+}
+
+bool SessionLog::flushDue(uint32_t nowMs, uint32_t maxHoldMs)
+{
+    if (pending_ == 0 || nowMs - pendingSinceMs_ < maxHoldMs)
+    {
+        return true;
+    }
+    return writePending();
+}
+
+bool SessionLog::flush()
+{
+    return pending_ == 0 || writePending();
+}
+
+bool SessionLog::startSegment()
+{
+    const uint32_t id = segmentCount_ ? segmentIds_[segmentCount_ - 1] + 1 : 1;
+    if (segmentCount_ == MAX_SEGMENTS)
+    {
+        storage_.remove(segmentIds_[0]);
+        stored_ -= segmentRecords_[0];
+        for (uint8_t i = 1; i < segmentCount_; ++i)
+        {
+            segmentIds_[i - 1] = segmentIds_[i];
+            segmentRecords_[i - 1] = segmentRecords_[i];
+        }
+        segmentCount_--;
+    }
+    segmentIds_[segmentCount_] = id;
+    segmentRecords_[segmentCount_] = 0;
+    segmentCount_++;
+    tailWritable_ = true;
+    return true;
+}
+
+bool SessionLog::writePending()
+{
+    uint8_t done = 0;
+    while (done < pending_)
+    {
+        if (!tailWritable_ || segmentRecords_[segmentCount_ - 1] >= SEGMENT_RECORDS)
+        {
+            startSegment();
+        }
+        const uint8_t tail = segmentCount_ - 1;
+        const uint32_t room = SEGMENT_RECORDS - segmentRecords_[tail];
+        const uint32_t left = static_cast<uint32_t>(pending_ - done);
+        const uint8_t n = static_cast<uint8_t>(left < room ? left : room);
+        if (!storage_.append(segmentIds_[tail], page_ + done * RECORD_BYTES, n * RECORD_BYTES))
+        {
+            // Keep the unwritten records; the segment may hold a partial write now, so do not reuse it.
+            writeErrors_++;
+            tailWritable_ = false;
+            memmove(page_, page_ + done * RECORD_BYTES, (pending_ - done) * RECORD_BYTES);
+            pending_ -= done;
+            return false;
+        }
+        flashWrites_++;
+        segmentRecords_[tail] += n;
+        stored_ += n;
+        done += n;
+    }
+    pending_ = 0;
+    return true;
+}
+
+bool SessionLog::read(uint32_t index, SessionRecord &out) const
+{
+    if (index >= stored_)
+    {
+        index -= stored_;
+        return index < pending_ && decode(page_ + index * RECORD_BYTES, out);
+    }
+    for (uint8_t i = 0; i < segmentCount_; ++i)
+    {
+        if (index < segmentRecords_[i])
+        {
+            uint8_t buf[RECORD_BYTES];
+            return storage_.read(segmentIds_[i], index * RECORD_BYTES, buf, RECORD_BYTES) && decode(buf, out);
+        }
+        index -= segmentRecords_[i];
+    }
+    return false;
+}
+
+bool SessionTracker::update(uint32_t nowMs, uint32_t epoch, bool relayOn, bool active, float temperature,
+                            float targetC, uint8_t reason, SessionRecord &closed)
+{
+    if (!open_)
+    {
+        if (!relayOn)
+        {
+            return false;
+        }
+        open_ = true;
+        startMs_ = nowMs;
+        lastMs_ = nowMs;
+        lastRelay_ = true;
+        onMs_ = 0;
+        heatMs_ = 0;
+        targetReached_ = temperature >= targetC;
+        startTemp_ = temperature;
+        return false;
+    }
+
+    if (!targetReached_ && temperature >= targetC)
+    {
+        targetReached_ = true;
+        heatMs_ = nowMs - startMs_;
+    }
+
+    if (lastRelay_)
+    {
+        onMs_ += nowMs - lastMs_;
+    }
+    lastMs_ = nowMs;
+    lastRelay_ = relayOn;
+    if (relayOn || active)
+    {
+        return false;
+    }
+
+    open_ = false;
+    if (epoch == 0)
+    {
+        return false;
+    }
+    const uint32_t durationSec = (nowMs - startMs_) / 1000UL;
+    closed.endTime = epoch;
+    closed.startTime = epoch - durationSec;
+    const uint32_t onMinutes = (onMs_ + 30000UL) / 60000UL;
+    closed.onMinutes = static_cast<uint16_t>(onMinutes > UINT16_MAX ? UINT16_MAX : onMinutes);
+    closed.heatMinutes = targetReached_ ? static_cast<uint16_t>((heatMs_ + 30000UL) / 60000UL) : SessionRecord::HEAT_UNKNOWN;
+    closed.startTemp = startTemp_;
+    closed.endTemp = temperature;
+    closed.reason = reason;
+    return true;
+}
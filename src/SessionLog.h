@@ -0,0 +1,120 @@
+#ifndef SESSION_LOG_H
+#define SESSION_LOG_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// One heating session: from the relay first switching on until heating is no longer requested.
+struct SessionRecord
+{
+    static constexpr uint16_t HEAT_UNKNOWN = 0xFFFF; // target not reached during the session
+
+    uint32_t startTime = 0; // epoch seconds
+    uint32_t endTime = 0;   // epoch seconds
+    uint16_t onMinutes = 0; // relay-on time within the session
+    uint16_t heatMinutes = HEAT_UNKNOWN; // from the start until the target temperature was first reached
+    float startTemp = 0.0f;
+    float endTemp = 0.0f;
+    uint8_t reason = 0; // StopReason of the last relay switch-off
+};
+
+// Segment files of the append-only log (LittleFS on the device, in-memory in the tests).
+// Segment ids only ever grow; the file name encodes the id so no record has to be read at boot.
+class SessionLogStorage
+{
+public:
+    virtual ~SessionLogStorage() = default;
+    // Ids of all existing segments (any order); returns how many were written to ids.
+    virtual uint8_t listSegments(uint32_t *ids, uint8_t maxIds) = 0;
+    virtual size_t segmentSize(uint32_t id) = 0;
+    virtual bool append(uint32_t id, const uint8_t *data, size_t len) = 0;
+    virtual bool read(uint32_t id, size_t offset, uint8_t *data, size_t len) = 0;
+    virtual bool remove(uint32_t id) = 0;
+};
+
+// Append-only, page-batched session log.
+// Records are 16 bytes (little endian, temperatures in 1/16 °C, end stored as whole minutes after
+// start, CRC-8 last byte):
+//   uint32 start | uint16 durationMin | uint16 onMinutes | uint16 heatMinutes | int16 startTemp |
+//   int16 endTemp | uint8 reason | uint8 crc
+// New records collect in a 256-byte page buffer and reach flash as one write when the page is
+// full or flushDue() decides they were held long enough. Segments hold SEGMENT_RECORDS records;
+// the oldest segment is deleted once MAX_SEGMENTS exist (64 KB, ~4000 sessions).
+class SessionLog
+{
+public:
+    static constexpr size_t RECORD_BYTES = 16;
+    static constexpr size_t PAGE_BYTES = 256;
+    static constexpr uint8_t RECORDS_PER_PAGE = PAGE_BYTES / RECORD_BYTES;
+    static constexpr uint32_t SEGMENT_RECORDS = 1024;
+    static constexpr uint8_t MAX_SEGMENTS = 4;
+
+    explicit SessionLog(SessionLogStorage &storage) : storage_(storage) {}
+
+    // Index the existing segments from their ids and sizes only. Returns the stored record count.
+    uint32_t begin();
+
+    // Queue a record; writes a page when the buffer is full. False if a flash write failed.
+    bool append(const SessionRecord &record, uint32_t nowMs);
+    // Write a partially filled page once its oldest record waited maxHoldMs.
+    bool flushDue(uint32_t nowMs, uint32_t maxHoldMs);
+    bool flush();
+
+    uint32_t size() const { return stored_ + pending_; } // stored + buffered
+    uint32_t storedCount() const { return stored_; }
+    uint8_t pendingCount() const { return pending_; }
+    uint8_t segmentCount() const { return segmentCount_; }
+    uint32_t flashWrites() const { return flashWrites_; }
+    uint32_t writeErrors() const { return writeErrors_; }
+
+    // Record by index, 0 = oldest. False for out-of-range indices or corrupt records.
+    bool read(uint32_t index, SessionRecord &out) const;
+
+    static void encode(const SessionRecord &record, uint8_t *out);
+    static bool decode(const uint8_t *in, SessionRecord &out);
+
+private:
+    bool writePending();
+    bool startSegment();
+
+    SessionLogStorage &storage_;
+    uint32_t segmentIds_[MAX_SEGMENTS] = {};     // oldest first
+    uint32_t segmentRecords_[MAX_SEGMENTS] = {}; // records per segment
+    uint8_t segmentCount_ = 0;
+    uint32_t stored_ = 0;
+    bool tailWritable_ = false; // newest segment may be appended to
+
+    uint8_t page_[PAGE_BYTES] = {};
+    uint8_t pending_ = 0;
+    uint32_t pendingSinceMs_ = 0;
+    uint32_t flashWrites_ = 0;
+    uint32_t writeErrors_ = 0;
+};
+
+// Turns the per-second relay/timer state into SessionRecords.
+class SessionTracker
+{
+public:
+    // active = heating still requested (relay on or timer running). Returns true and fills
+    // closed when a session just ended; sessions without a synced clock (epoch 0) are dropped.
+    bool update(uint32_t nowMs, uint32_t epoch, bool relayOn, bool active, float temperature,
+                float targetC, uint8_t reason, SessionRecord &closed);
+
+    bool open() const { return open_; }
+    uint32_t openSinceMs() const { return startMs_; }
+    float openStartTemp() const { return startTemp_; }
+
+private:
+    bool open_ = false;
+    uint32_t startMs_ = 0;
+    uint32_t lastMs_ = 0;
+    uint32_t onMs_ = 0;
+    uint32_t heatMs_ = 0;
+    bool targetReached_ = false;
+    bool lastRelay_ = false;
+    float startTemp_ = 0.0f;
+};
+
+#endif // SESSION_LOG_H
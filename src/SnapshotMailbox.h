@@ -0,0 +1,55 @@
+#ifndef SNAPSHOT_MAILBOX_H
+#define SNAPSHOT_MAILBOX_H
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-slot mailbox between one producer and one consumer task (triple buffer).
+// The producer always overwrites the latest value and never waits; the consumer takes the
+// newest complete snapshot, skipping any it missed. T must be trivially copyable.
+template <typename T>
+class SnapshotMailbox
+{
+public:
+    // Producer side.
+    void publish(const T &value)
+    {
+        buffers_[back_] = value;
+        const uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | FRESH), std::memory_order_acq_rel);
+        back_ = previous & INDEX_MASK;
+        published_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Consumer side. Returns false when nothing new was published since the last take().
+    bool take(T &out)
+    {
+        if (!(middle_.load(std::memory_order_acquire) & FRESH))
+        {
+            return false;
+        }
+        const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & INDEX_MASK;
+        out = buffers_[front_];
+        taken_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool hasNew() const { return (middle_.load(std::memory_order_acquire) & FRESH) != 0; }
+    uint32_t publishedCount() const { return published_.load(std::memory_order_relaxed); }
+    uint32_t takenCount() const { return taken_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t FRESH = 0x80;
+    static constexpr uint8_t INDEX_MASK = 0x03;
+
+    T buffers_[3] = {};
+    uint8_t back_ = 0;                 // producer-owned
+    uint8_t front_ = 1;                // consumer-owned
+    std::atomic<uint8_t> middle_{2};   // shared, FRESH flag set when unread
+    std::atomic<uint32_t> published_{0};
+    std::atomic<uint32_t> taken_{0};
+};
+
+#endif // SNAPSHOT_MAILBOX_H
@@ -0,0 +1,138 @@
+#include "TankModel.h"
+
+namespace
+{
+    float ewma(float current, float sample, uint16_t samples)
+    {
+        return samples == 0 ? sample : current + TankModel::EWMA_ALPHA * (sample - current);
+    }
+}
+
+void TankModel::reset()
+{
+    *this = TankModel();
+}
+
+void TankModel::restartWindow(uint32_t nowMs, float temperatureC)
+{
+    anchorMs_ = nowMs;
+    anchorC_ = temperatureC;
+}
+
+void TankModel::finishOvershoot()
+{
+    trackingOvershoot_ = false;
+    float rise = peakC_ - offTempC_;
+    if (rise < 0.0f)
+    {
+        rise = 0.0f;
+    }
+    if (rise > MAX_OVERSHOOT_C)
+    {
+        rise = MAX_OVERSHOOT_C;
+    }
+    overshootC_ = ewma(overshootC_, rise, overshootRuns_);
+    overshootRuns_++;
+}
+
+void TankModel::addSample(uint32_t nowMs, float temperatureC, bool relayOn)
+{
+    if (!started_ || nowMs - lastMs_ > MAX_GAP_MS)
+    {
+        started_ = true;
+        relayOn_ = relayOn;
+        switchMs_ = nowMs;
+        lastMs_ = nowMs;
+        trackingOvershoot_ = false;
+        restartWindow(nowMs, temperatureC);
+        return;
+    }
+    lastMs_ = nowMs;
+
+    if (relayOn != relayOn_)
+    {
+        if (relayOn_ && !relayOn)
+        {
+            trackingOvershoot_ = true; // heating run ended: watch the residual rise
+            offTempC_ = temperatureC;
+            peakC_ = temperatureC;
+        }
+        else
+        {
+            trackingOvershoot_ = false; // reheated before the peak was seen
+        }
+        relayOn_ = relayOn;
+        switchMs_ = nowMs;
+        restartWindow(nowMs, temperatureC);
+        return;
+    }
+
+    if (trackingOvershoot_)
+    {
+        if (temperatureC > peakC_)
+        {
+            peakC_ = temperatureC;
+        }
+        if (nowMs - switchMs_ >= OVERSHOOT_WINDOW_MS || temperatureC < peakC_ - 0.5f)
+        {
+            finishOvershoot();
+        }
+    }
+
+    if (nowMs - switchMs_ < SETTLE_MS)
+    {
+        restartWindow(nowMs, temperatureC); // still settling after the switch
+        return;
+    }
+
+    const uint32_t elapsedMs = nowMs - anchorMs_;
+    if (elapsedMs < RATE_WINDOW_MS)
+    {
+        return;
+    }
+
+    const float rate = (temperatureC - anchorC_) * 60000.0f / static_cast<float>(elapsedMs);
+    if (relayOn_)
+    {
+        heatRate_ = ewma(heatRate_, rate, heatWindows_);
+        if (heatWindows_ < UINT16_MAX)
+        {
+            heatWindows_++;
+        }
+    }
+    else
+    {
+        coolRate_ = ewma(coolRate_, rate, coolWindows_);
+        if (coolWindows_ < UINT16_MAX)
+        {
+            coolWindows_++;
+        }
+    }
+    restartWindow(nowMs, temperatureC);
+}
+
+int32_t TankModel::secondsToTarget(float currentC, float targetC) const
+{
+    if (currentC >= targetC)
+    {
+        return 0;
+    }
+    if (!heatingKnown() || heatRate_ < MIN_HEAT_RATE)
+    {
+        return -1;
+    }
+    return static_cast<int32_t>((targetC - currentC) / heatRate_ * 60.0f + 0.5f);
+}
+
+int32_t TankModel::secondsUntilBelow(float currentC, float thresholdC) const
+{
+    if (currentC <= thresholdC)
+    {
+        return 0;
+    }
+    if (!coolingKnown() || coolRate_ >= 0.0f)
+    {
+        return -1;
+    }
+    return static_cast<int32_t>((currentC - thresholdC) / -coolRate_ * 60.0f + 0.5f);
+}
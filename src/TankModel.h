@@ -0,0 +1,63 @@
+#ifndef TANK_MODEL_H
+#define TANK_MODEL_H
+
+#pragma once
+
+#include <cstdint>
+
+// Online tank model learned from the sensor history (no Arduino dependencies).
+// Heating and cooling rates (°C/min) are measured over fixed windows of one relay state and
+// smoothed with an EWMA; the first SETTLE_MS after a relay switch is ignored (burner and
+// mixing lag). After each heating run the overshoot (rise after the relay went off) is
+// learned as well, so the controller can stop early and still coast to the target.
+class TankModel
+{
+public:
+    static constexpr uint32_t RATE_WINDOW_MS = 60000;
+    static constexpr uint32_t SETTLE_MS = 120000;
+    static constexpr uint32_t MAX_GAP_MS = 5UL * 60000; // longer sample gaps restart the window
+    static constexpr uint32_t OVERSHOOT_WINDOW_MS = 15UL * 60000;
+    static constexpr float EWMA_ALPHA = 0.3f;
+    static constexpr uint8_t MIN_WINDOWS = 2;      // windows before a rate is trusted
+    static constexpr float MIN_HEAT_RATE = 0.02f;  // °C/min, below this no prediction is made
+    static constexpr float MAX_OVERSHOOT_C = 5.0f; // clamp for a single overshoot sample
+
+    void addSample(uint32_t nowMs, float temperatureC, bool relayOn);
+    void reset();
+
+    bool heatingKnown() const { return heatWindows_ >= MIN_WINDOWS; }
+    bool coolingKnown() const { return coolWindows_ >= MIN_WINDOWS; }
+    bool overshootKnown() const { return overshootRuns_ > 0; }
+    float heatingRate() const { return heatRate_; } // °C/min with the relay on
+    float coolingRate() const { return coolRate_; } // °C/min with the relay off (usually < 0)
+    float overshootC() const { return overshootC_; }
+
+    // Seconds of heating until target is reached (0 = already there, -1 = unknown).
+    int32_t secondsToTarget(float currentC, float targetC) const;
+    // Seconds until the tank cools down to thresholdC with the relay off (-1 = unknown/never).
+    int32_t secondsUntilBelow(float currentC, float thresholdC) const;
+
+private:
+    void restartWindow(uint32_t nowMs, float temperatureC);
+    void finishOvershoot();
+
+    bool started_ = false;
+    bool relayOn_ = false;
+    uint32_t switchMs_ = 0;
+    uint32_t lastMs_ = 0;
+    uint32_t anchorMs_ = 0;
+    float anchorC_ = 0.0f;
+
+    float heatRate_ = 0.0f;
+    float coolRate_ = 0.0f;
+    uint16_t heatWindows_ = 0;
+    uint16_t coolWindows_ = 0;
+
+    bool trackingOvershoot_ = false;
+    float offTempC_ = 0.0f;
+    float peakC_ = 0.0f;
+    float overshootC_ = 0.0f;
+    uint16_t overshootRuns_ = 0;
+};
+
+#endif // TANK_MODEL_H
@@ -0,0 +1,85 @@
+#include "TempFilter.h"
+
+void TempFilter::configure(const Config &config)
+{
+    Config next = config;
+    if (next.medianN < 1)
+    {
+        next.medianN = 1;
+    }
+    if (next.medianN > MAX_MEDIAN)
+    {
+        next.medianN = MAX_MEDIAN;
+    }
+    if ((next.medianN & 1) == 0)
+    {
+        next.medianN++; // odd window: the median is always a real sample
+    }
+    if (next.emaAlpha <= 0.0f || next.emaAlpha > 1.0f)
+    {
+        next.emaAlpha = 1.0f;
+    }
+    if (next.maxRatePerMin < 0.0f)
+    {
+        next.maxRatePerMin = 0.0f;
+    }
+    if (next.medianN != config_.medianN)
+    {
+        reset();
+    }
+    config_ = next;
+}
+
+void TempFilter::reset()
+{
+    head_ = 0;
+    count_ = 0;
+}
+
+float TempFilter::median() const
+{
+    float sorted[MAX_MEDIAN];
+    for (uint8_t i = 0; i < count_; ++i)
+    {
+        // Insertion sort, N <= 7
+        const float v = window_[i];
+        int8_t j = static_cast<int8_t>(i) - 1;
+        while (j >= 0 && sorted[j] > v)
+        {
+            sorted[j + 1] = sorted[j];
+            --j;
+        }
+        sorted[j + 1] = v;
+    }
+    return sorted[(count_ - 1) / 2]; // lower median while the window fills up
+}
+
+float TempFilter::apply(float rawC, uint32_t nowMs)
+{
+    window_[head_] = rawC;
+    head_ = static_cast<uint8_t>((head_ + 1) % config_.medianN);
+    const bool first = count_ == 0;
+    if (count_ < config_.medianN)
+    {
+        count_++;
+    }
+    const float m = median();
+
+    ema_ = first ? m : ema_ + config_.emaAlpha * (m - ema_);
+
+    float out = ema_;
+    if (!first && config_.maxRatePerMin > 0.0f)
+    {
+        const float maxStep = config_.maxRatePerMin * static_cast<float>(nowMs - lastMs_) / 60000.0f;
+        const float step = out - output_;
+        if (step > maxStep || step < -maxStep)
+        {
+            out = output_ + (step > 0.0f ? maxStep : -maxStep);
+            ema_ = out; // keep the EMA on the limited path so it does not wind up
+            limited_++;
+        }
+    }
+    output_ = out;
+    lastMs_ = nowMs;
+    return out;
+}
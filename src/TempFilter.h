@@ -0,0 +1,47 @@
+#ifndef TEMP_FILTER_H
+#define TEMP_FILTER_H
+
+#pragma once
+
+#include <cstdint>
+
+// Allocation-free conditioning for the control temperature (no Arduino dependencies).
+// Stages, each optional: median of the last N samples (rejects single outliers), exponential
+// moving average, then a rate-of-change limiter on the output. Feed only valid readings;
+// call reset() after a sensor fault so stale samples do not leak into the new series.
+class TempFilter
+{
+public:
+    static constexpr uint8_t MAX_MEDIAN = 7;
+
+    struct Config
+    {
+        uint8_t medianN = 5;        // window size, 1 = off (even sizes are rounded up)
+        float emaAlpha = 0.5f;      // weight of the new sample, 1 = off
+        float maxRatePerMin = 3.0f; // °C/min on the output, 0 = off
+    };
+
+    void configure(const Config &config);
+    const Config &config() const { return config_; }
+    void reset();
+
+    float apply(float rawC, uint32_t nowMs);
+
+    bool primed() const { return count_ > 0; }
+    float last() const { return output_; }
+    uint32_t limitedCount() const { return limited_; } // samples clamped by the rate limiter
+
+private:
+    float median() const;
+
+    Config config_;
+    float window_[MAX_MEDIAN] = {};
+    uint8_t head_ = 0;
+    uint8_t count_ = 0;
+    float ema_ = 0.0f;
+    float output_ = 0.0f;
+    uint32_t lastMs_ = 0;
+    uint32_t limited_ = 0;
+};
+
+#endif // TEMP_FILTER_H
@@ -0,0 +1,268 @@
+#include "TempSensorReader.h"
+
+#include <cstring>
+
+void TempSensorReader::begin(DallasTemperature *sensor, uint8_t resolutionBits, uint8_t oversample)
+{
+    sensor_ = sensor;
+    setMode(resolutionBits, oversample);
+    state_ = State::Idle;
+    requestPending_ = true;
+    sensorCount_ = 0; // slots are pinned in discovery order from here on
+    presentMask_ = 0;
+    if (!sensor_)
+    {
+        return;
+    }
+    scanBus(millis());
+    applyMode();
+}
+
+uint8_t TempSensorReader::rescan(uint32_t nowMs)
+{
+    if (!sensor_ || state_ != State::Idle)
+    {
+        return sensorCount_;
+    }
+    sensor_->begin(); // new search; getDeviceCount() only reports the result of the last one
+    scanBus(nowMs);
+    rescanCount_++;
+    applyMode(); // a new probe starts at its power-on resolution
+    requestPending_ = true;
+    return presentCount();
+}
+
+uint8_t TempSensorReader::presentCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < sensorCount_; ++i)
+    {
+        count += present(i) ? 1 : 0;
+    }
+    return count;
+}
+
+int8_t TempSensorReader::slotOf(const uint8_t *rom) const
+{
+    for (uint8_t i = 0; i < sensorCount_; ++i)
+    {
+        if (memcmp(addresses_[i], rom, sizeof(DeviceAddress)) == 0)
+        {
+            return static_cast<int8_t>(i);
+        }
+    }
+    return -1;
+}
+
+// The search order follows the ROM bits, not the wiring, so a probe joining or leaving the bus
+// can shift every index; slots are therefore matched by ROM and never reordered.
+void TempSensorReader::scanBus(uint32_t nowMs)
+{
+    presentMask_ = 0;
+    const uint8_t found = sensor_->getDeviceCount();
+    for (uint8_t i = 0; i < found; ++i)
+    {
+        DeviceAddress rom;
+        if (!sensor_->getAddress(rom, i))
+        {
+            continue;
+        }
+        int8_t slot = slotOf(rom);
+        if (slot < 0 && sensorCount_ < MAX_SENSORS)
+        {
+            slot = static_cast<int8_t>(sensorCount_++);
+            memcpy(addresses_[slot], rom, sizeof(DeviceAddress));
+            lastRawC_[slot] = DEVICE_DISCONNECTED_C;
+        }
+        if (slot >= 0)
+        {
+            presentMask_ |= static_cast<uint8_t>(1u << slot);
+        }
+    }
+
+    // Never block inside requestTemperatures(); completion is checked from update().
+    sensor_->setWaitForConversion(false);
+    sensor_->setCheckForConversion(true);
+    parasitePower_ = sensor_->isParasitePowerMode();
+    faultStreak_ = 0;
+    lastScanMs_ = nowMs;
+}
+
+void TempSensorReader::setIntervalMs(uint32_t intervalMs)
+{
+    intervalMs_ = intervalMs;
+}
+
+void TempSensorReader::setMode(uint8_t resolutionBits, uint8_t oversample)
+{
+    pendingBits_ = constrain(resolutionBits, 9, 12);
+    pendingOversample_ = constrain(oversample, 1, MAX_OVERSAMPLE);
+    modePending_ = pendingBits_ != resolutionBits_ || pendingOversample_ != oversample_;
+}
+
+void TempSensorReader::applyMode()
+{
+    resolutionBits_ = pendingBits_;
+    oversample_ = pendingOversample_;
+    modePending_ = false;
+    if (sensor_ && sensorCount_ > 0)
+    {
+        sensor_->setResolution(resolutionBits_); // scratchpad write to every probe on the bus
+    }
+    conversionWaitMs_ = sensor_ ? static_cast<uint32_t>(sensor_->millisToWaitForConversion(resolutionBits_)) : 750;
+}
+
+void TempSensorReader::requestNow()
+{
+    requestPending_ = true;
+}
+
+bool TempSensorReader::update(uint32_t nowMs)
+{
+    if (!sensor_)
+    {
+        return false;
+    }
+    if (state_ == State::Idle && (sensorCount_ == 0 || faultStreak_ >= RESCAN_AFTER_FAULTS) &&
+        nowMs - lastScanMs_ >= RESCAN_MIN_MS)
+    {
+        rescan(nowMs);
+    }
+    if (sensorCount_ == 0)
+    {
+        return false;
+    }
+
+    switch (state_)
+    {
+    case State::Idle:
+        if (requestPending_ || (nowMs - sampleStartMs_ >= intervalMs_))
+        {
+            const uint32_t startUs = micros();
+            if (modePending_)
+            {
+                applyMode();
+            }
+            burstDone_ = 0;
+            burstFaults_ = 0;
+            for (uint8_t i = 0; i < sensorCount_; ++i)
+            {
+                burstSumC_[i] = 0.0f;
+            }
+            sampleStartMs_ = nowMs;
+            const uint32_t setupUs = micros() - startUs;
+            startConversion(nowMs);
+            pendingBusyUs_ += setupUs;
+        }
+        return false;
+
+    case State::Converting:
+    {
+        const uint32_t elapsedMs = nowMs - lastRequestMs_;
+        if (elapsedMs < conversionWaitMs_)
+        {
+            return false;
+        }
+
+        // Parasite powered sensors cannot signal completion on the bus; rely on the datasheet time.
+        if (!parasitePower_)
+        {
+            const uint32_t startUs = micros();
+            const bool done = sensor_->isConversionComplete();
+            pendingBusyUs_ += micros() - startUs;
+            if (!done)
+            {
+                if (elapsedMs < conversionWaitMs_ * 2)
+                {
+                    return false; // not ready yet, check again on the next loop pass
+                }
+                timeoutCount_++; // read anyway, the caller sees the fault code
+            }
+        }
+        return collect(nowMs);
+    }
+    }
+    return false;
+}
+
+uint32_t TempSensorReader::nextActionMs(uint32_t nowMs) const
+{
+    if (sensor_ && sensorCount_ == 0)
+    {
+        return lastScanMs_ + RESCAN_MIN_MS;
+    }
+    if (state_ == State::Idle)
+    {
+        return requestPending_ ? nowMs : sampleStartMs_ + intervalMs_;
+    }
+    const uint32_t readyMs = lastRequestMs_ + conversionWaitMs_;
+    if (static_cast<int32_t>(nowMs - readyMs) >= 0)
+    {
+        return nowMs + COMPLETION_POLL_MS;
+    }
+    return readyMs;
+}
+
+void TempSensorReader::startConversion(uint32_t nowMs)
+{
+    const uint32_t startUs = micros();
+    sensor_->requestTemperatures(); // skip-ROM broadcast: every probe converts in parallel
+    if (burstDone_ == 0)
+    {
+        pendingBusyUs_ = 0;
+    }
+    pendingBusyUs_ += micros() - startUs;
+
+    lastRequestMs_ = nowMs;
+    requestPending_ = false;
+    state_ = State::Converting;
+}
+
+bool TempSensorReader::collect(uint32_t nowMs)
+{
+    const uint32_t startUs = micros();
+    for (uint8_t i = 0; i < sensorCount_; ++i)
+    {
+        const float c = sensor_->getTempC(addresses_[i]); // match-ROM read, no bus search
+        // 85 °C is the power-on value of a probe that lost its supply mid-burst
+        if (c <= DEVICE_DISCONNECTED_C || c >= 85.0f)
+        {
+            burstFaults_ |= static_cast<uint8_t>(1u << i);
+        }
+        burstSumC_[i] += c;
+    }
+    pendingBusyUs_ += micros() - startUs;
+    lastConversionMs_ = nowMs - lastRequestMs_;
+
+    if (++burstDone_ < oversample_)
+    {
+        startConversion(nowMs); // next conversion of the burst right away
+        return false;
+    }
+
+    for (uint8_t i = 0; i < sensorCount_; ++i)
+    {
+        // A single conversion keeps its raw fault code for the log; a burst with a failed one is void
+        const bool fault = oversample_ > 1 && (burstFaults_ & (1u << i));
+        lastRawC_[i] = fault ? DEVICE_DISCONNECTED_C : burstSumC_[i] / oversample_;
+    }
+    if (burstFaults_ != 0)
+    {
+        if (faultStreak_ < UINT8_MAX)
+        {
+            faultStreak_++;
+        }
+    }
+    else
+    {
+        faultStreak_ = 0;
+    }
+    lastSampleMs_ = nowMs - sampleStartMs_;
+    lastBusyUs_ = pendingBusyUs_;
+    if (lastBusyUs_ > maxBusyUs_)
+    {
+        maxBusyUs_ = lastBusyUs_;
+    }
+    state_ = State::Idle;
+    return true;
+}
@@ -0,0 +1,116 @@
+#ifndef TEMP_SENSOR_READER_H
+#define TEMP_SENSOR_READER_H
+
+#pragma once
+
+#include <Arduino.h>
+#include <DallasTemperature.h>
+
+// Non-blocking DS18B20 read pipeline.
+// A read is split into "request conversion" and "collect result" steps that are
+// advanced from loop(). Between the two steps the CPU is free for web/MQTT/display.
+// Up to MAX_SENSORS probes share the bus: their ROM IDs are discovered in begin() and pinned to
+// a slot (slot 0 drives the control). The bus is searched again (rate limited) while no probe is
+// known or after repeated faulty samples; a search keeps every slot on its ROM and only fills
+// free slots, so a probe that was missing at boot is picked up without a reboot, while a missing
+// pinned probe keeps reporting a fault instead of another probe taking its place.
+// One skip-ROM broadcast starts all conversions at the same time, and the results are read by
+// address, so a sample takes one conversion period regardless of the probe count.
+// With oversampling, one sample is the average of several back-to-back conversions (a burst);
+// a lower resolution converts much faster (9 bit ~94 ms vs 12 bit ~750 ms), so e.g. four
+// averaged 10-bit conversions cost about as much time as one 12-bit conversion.
+class TempSensorReader
+{
+public:
+    enum class State : uint8_t
+    {
+        Idle,       // waiting for the next read interval
+        Converting, // conversion requested, waiting for the sensor
+    };
+
+    static constexpr uint8_t MAX_SENSORS = 3;
+    static constexpr uint8_t MAX_OVERSAMPLE = 8;
+
+    static constexpr uint32_t RESCAN_MIN_MS = 10000;  // at most one bus search per period
+    static constexpr uint8_t RESCAN_AFTER_FAULTS = 3; // consecutive faulty samples before a search
+
+    // Scans the bus and caches the ROM IDs.
+    void begin(DallasTemperature *sensor, uint8_t resolutionBits, uint8_t oversample = 1);
+    // Search the bus again now (only while idle); returns the number of pinned probes found.
+    uint8_t rescan(uint32_t nowMs);
+    void setIntervalMs(uint32_t intervalMs);
+    // Takes effect at the start of the next sample; a running burst finishes in the old mode.
+    void setMode(uint8_t resolutionBits, uint8_t oversample);
+    uint8_t resolutionBits() const { return resolutionBits_; }
+    uint8_t oversample() const { return oversample_; }
+    void requestNow(); // start a new conversion on the next update()
+
+    // Advance the state machine. Returns true when a new sample is available.
+    bool update(uint32_t nowMs);
+    // Absolute time (ms) at which update() has work to do next; lets the loop sleep until then.
+    uint32_t nextActionMs(uint32_t nowMs) const;
+
+    State state() const { return state_; }
+    uint8_t sensorCount() const { return sensorCount_; } // pinned slots, present or not
+    // Whether the probe pinned to a slot answered the last bus search.
+    bool present(uint8_t index) const { return index < sensorCount_ && (presentMask_ & (1u << index)); }
+    uint8_t presentCount() const;
+    const uint8_t *address(uint8_t index) const { return index < sensorCount_ ? addresses_[index] : nullptr; }
+    // Raw reading of one probe, averaged over the burst (DEVICE_DISCONNECTED_C when missing or
+    // when any conversion of the burst failed).
+    float lastRawC(uint8_t index = 0) const { return index < sensorCount_ ? lastRawC_[index] : DEVICE_DISCONNECTED_C; }
+
+    // Time from conversion request until the result was collected (one conversion).
+    uint32_t lastConversionMs() const { return lastConversionMs_; }
+    // Time from the first request until the averaged sample was ready (whole burst).
+    uint32_t lastSampleMs() const { return lastSampleMs_; }
+    // CPU time spent inside the pipeline for the last sample (request + collect).
+    uint32_t lastBusyUs() const { return lastBusyUs_; }
+    uint32_t maxBusyUs() const { return maxBusyUs_; }
+    uint32_t timeoutCount() const { return timeoutCount_; }
+    uint32_t rescanCount() const { return rescanCount_; }
+
+private:
+    static constexpr uint32_t COMPLETION_POLL_MS = 10; // re-check interval once the datasheet time has passed
+
+    void scanBus(uint32_t nowMs);
+    int8_t slotOf(const uint8_t *rom) const;
+    void applyMode();
+    void startConversion(uint32_t nowMs);
+    bool collect(uint32_t nowMs);
+
+    DallasTemperature *sensor_ = nullptr;
+    DeviceAddress addresses_[MAX_SENSORS] = {};
+    uint8_t sensorCount_ = 0;
+    uint8_t presentMask_ = 0; // bit per slot
+    State state_ = State::Idle;
+    uint8_t resolutionBits_ = 12;
+    uint8_t oversample_ = 1;
+    uint8_t pendingBits_ = 12;
+    uint8_t pendingOversample_ = 1;
+    bool modePending_ = false;
+    bool parasitePower_ = false;
+    bool requestPending_ = true;
+
+    uint32_t intervalMs_ = 10000;
+    uint32_t sampleStartMs_ = 0; // first request of the current burst, paces the interval
+    uint32_t lastRequestMs_ = 0;
+    uint32_t conversionWaitMs_ = 750;
+
+    uint8_t burstDone_ = 0;
+    float burstSumC_[MAX_SENSORS] = {};
+    uint8_t burstFaults_ = 0; // bit per sensor
+    uint8_t faultStreak_ = 0; // consecutive samples with a faulty probe
+    uint32_t lastScanMs_ = 0;
+    uint32_t rescanCount_ = 0;
+
+    float lastRawC_[MAX_SENSORS] = {DEVICE_DISCONNECTED_C, DEVICE_DISCONNECTED_C, DEVICE_DISCONNECTED_C};
+    uint32_t lastConversionMs_ = 0;
+    uint32_t lastSampleMs_ = 0;
+    uint32_t pendingBusyUs_ = 0;
+    uint32_t lastBusyUs_ = 0;
+    uint32_t maxBusyUs_ = 0;
+    uint32_t timeoutCount_ = 0;
+};
+
+#endif // TEMP_SENSOR_READER_H
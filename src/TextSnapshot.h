@@ -0,0 +1,120 @@
+#ifndef TEXT_SNAPSHOT_H
+#define TEXT_SNAPSHOT_H
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Double-buffered text (JSON, formatted values) written by one task and copied out by any
+// number of readers on other tasks/cores. The writer fills the back slot and then flips the
+// front index, so it never waits. Each slot carries a sequence counter (odd while being
+// written); a reader that raced with a rewrite of its slot sees the counter change and retries.
+template <size_t N>
+class TextSnapshot
+{
+public:
+    static constexpr size_t CAPACITY = N;
+    static constexpr uint8_t MAX_READ_TRIES = 4;
+
+    // Writer side: fill the returned buffer (CAPACITY bytes), then commit() the length.
+    char *beginWrite()
+    {
+        Slot &s = slots_[back_];
+        s.seq.fetch_add(1, std::memory_order_relaxed); // odd: readers of this slot retry
+        std::atomic_thread_fence(std::memory_order_release);
+        return s.text;
+    }
+
+    void commit(size_t len)
+    {
+        Slot &s = slots_[back_];
+        s.len = len < N ? len : N - 1;
+        s.text[s.len] = '\0';
+        s.seq.fetch_add(1, std::memory_order_release); // even again
+        front_.store(back_, std::memory_order_release);
+        back_ ^= 1;
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Drop a started write (e.g. the text did not fit); the front slot stays as it was.
+    void cancelWrite()
+    {
+        slots_[back_].seq.fetch_add(1, std::memory_order_release);
+    }
+
+    // Writer convenience for short strings.
+    void set(const char *text)
+    {
+        char *dst = beginWrite();
+        size_t len = strlen(text);
+        if (len >= N)
+        {
+            len = N - 1;
+        }
+        memcpy(dst, text, len);
+        commit(len);
+    }
+
+    // Reader side: copies the newest committed text (NUL terminated) and returns its length;
+    // 0 when nothing was committed yet or the writer kept overtaking the copy.
+    size_t read(char *out, size_t cap) const
+    {
+        if (cap == 0)
+        {
+            return 0;
+        }
+        out[0] = '\0';
+        if (version_.load(std::memory_order_acquire) == 0)
+        {
+            return 0;
+        }
+        for (uint8_t attempt = 0; attempt < MAX_READ_TRIES; ++attempt)
+        {
+            const Slot &s = slots_[front_.load(std::memory_order_acquire)];
+            const uint32_t before = s.seq.load(std::memory_order_acquire);
+            if (before & 1U)
+            {
+                retries_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            size_t len = s.len;
+            if (len >= cap)
+            {
+                len = cap - 1;
+            }
+            memcpy(out, s.text, len);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) == before)
+            {
+                out[len] = '\0';
+                return len;
+            }
+            retries_.fetch_add(1, std::memory_order_relaxed);
+        }
+        out[0] = '\0';
+        return 0;
+    }
+
+    // Number of commits so far (0 = empty); readers can use it as a cheap change marker.
+    uint32_t version() const { return version_.load(std::memory_order_acquire); }
+    uint32_t readRetries() const { return retries_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> seq{0};
+        size_t len = 0;
+        char text[N] = {};
+    };
+
+    Slot slots_[2];
+    uint8_t back_ = 0; // writer-owned
+    std::atomic<uint8_t> front_{1};
+    std::atomic<uint32_t> version_{0};
+    mutable std::atomic<uint32_t> retries_{0};
+};
+
+#endif // TEXT_SNAPSHOT_H
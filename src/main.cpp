@@ -7,6 +7,9 @@
 #include <WiFi.h>
 #include <Preferences.h>
 #include <time.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <esp_system.h>
 
 #include <OneWire.h>
 #include <DallasTemperature.h>
@@ -21,6 +24,29 @@
 #define CM_HAS_WIFI_SECRETS 0
 #endif
 #include "settings.h"
+#include "TempSensorReader.h"
+#include "BoilerControl.h"
+#include "LoopProfiler.h"
+#include "LoopScheduler.h"
+#include "MqttTopics.h"
+#include "MqttDispatch.h"
+#include "PublishCache.h"
+#include "DisplayDirty.h"
+#include "SnapshotMailbox.h"
+#include "Seqlock.h"
+#include "CommandQueue.h"
+#include "PersistTracker.h"
+#include "BootTimeline.h"
+#include "TankModel.h"
+#include "HistoryRing.h"
+#include "SessionLog.h"
+#include "HeatSchedule.h"
+#include "PreheatModel.h"
+#include "TempFilter.h"
+#include "SensorModeStats.h"
+#include "TextSnapshot.h"
+#include "DeltaTracker.h"
+#include "HeapProbe.h"
 #include "helpers/HelperModule.h"
 
 #include "core/CoreSettings.h"
@@ -41,18 +67,41 @@
 #define OTA_PASSWORD SETTINGS_PASSWORD
 #endif
 
+// Per-stage loop() cycle histograms (live card + /perf.json). Set to 0 to compile the probes out.
+#ifndef BOILER_LOOP_PROFILER
+#define BOILER_LOOP_PROFILER 1
+#endif
+
+// SSD1306 rendering and I2C transfers run in their own task on the other core (0 = inline in loop()).
+#ifndef BOILER_DISPLAY_TASK
+#define BOILER_DISPLAY_TASK 1
+#endif
+#ifndef DISPLAY_TASK_CORE
+#define DISPLAY_TASK_CORE 0 // Arduino loop() runs on core 1
+#endif
+
+// App data endpoints (/perf.json, ...) run on their own port; the UI server is owned by ConfigManager.
+#ifndef APP_API_PORT
+#define APP_API_PORT 8080
+#endif
+
 // predeclare the functions (prototypes)
 static void setupLogging();
 static void setupGUI();
 static void setupMQTT();
 static void updateMqttTopics();
+static void setupMqttDispatch();
 static void setupMqttCallbacks();
 static void handleMqttMessage(const char *topic, const uint8_t *payload, unsigned int length);
 static void publishMqttState(bool retained);
 static void publishMqttStateIfNeeded();
+static void requestStatePublish();
+static void publishJsonState(bool retained);
 static void registerIOBindings();
 static void SetupStartDisplay();
-static void WriteToDisplay();
+struct DisplaySnapshot;
+static void WriteToDisplay(const DisplaySnapshot &snap);
+static void startDisplayTask();
 static bool SetupStartWebServer();
 static void ShowDisplay();
 static void ShowDisplayOff();
@@ -61,12 +110,52 @@ static void handeleBoilerState(bool forceON = false);
 static void UpdateBoilerAlarmState();
 static void setBoilerState(bool on);
 static bool getBoilerState();
-static void cb_readTempSensor();
+static void applyTempReading(float rawC);
 static void setupTempSensor();
 static void applyTempReadInterval();
+static void applyTempSensorMode();
+static String describeSensorModes(uint8_t bits);
 static void handleShowerRequest(bool requested);
+static void syncBoilerConfig();
+static void applySchedule();
+static void learnPreheat(const SessionRecord &record);
+static void checkPreheatOutcome(uint32_t minuteNow);
 static void setupNetworkDefaults();
 static void applyWiFiMacPriority();
+static void setupLoopProfiler();
+static void setupLoopScheduler();
+static void wakeLoop(uint8_t task);
+static void taskIo();
+static void taskNet();
+static void taskSensor();
+static void taskDisplay();
+static void taskAlarm();
+static void taskPublish();
+static void taskBoiler();
+static void taskLed();
+static void taskSnapshot();
+static void publishControlState();
+static void taskCommand();
+static void taskPersist();
+static void taskBoot();
+static void readFirstTemperature();
+static void applyExtraSensorReadings();
+static void trackPersistedSettings(bool flush);
+static uint32_t persistFingerprint(uint8_t key);
+static void markSettingsStored();
+static void noteSettingChanged(uint8_t key);
+enum class CommandType : uint8_t;
+enum class CommandSource : uint8_t;
+static bool postCommand(CommandType type, CommandSource source, bool b = false, int32_t i = 0, float f = 0.0f);
+static void updateRuntimeSnapshot();
+static void formatNextShower(char *out, size_t size);
+static void setupApiServer();
+static void recordHistory(uint32_t nowMs);
+static void sendHistory(AsyncWebServerRequest *request, bool binary);
+static void setupSessionLog();
+static void flushSessionsOnShutdown();
+static void trackSession();
+static void sendSessions(AsyncWebServerRequest *request);
 
 //--------------------------------------------------------------------------------------------------------------
 
@@ -96,56 +185,387 @@ static cm::MQTTManager::Settings &mqttSettings = mqtt.settings();
 static cm::CoreWiFiServices wifiServices;
 
 static Adafruit_SSD1306 display(4);
+static AsyncWebServer apiServer(APP_API_PORT);
 
 static constexpr char IO_BOILER_ID[] = "boiler";
 static constexpr char IO_RESET_ID[] = "reset_btn";
 static constexpr char IO_AP_ID[] = "ap_btn";
 static constexpr char IO_SHOWER_ID[] = "shower_btn";
 
-static String mqttBaseTopic;
-static String topicSetShowerTime;
-static String topicWillShower;
-static String topicSave;
-static String topicBoilerEnabled;
-static String topicOnThreshold;
-static String topicOffThreshold;
-static String topicBoilerTimeMin;
-static String topicStopTimerOnTarget;
-static String topicOncePerPeriod;
-static String topicYouCanShowerPeriodMin;
-static String topicActualState;
-static String topicActualBoilerTemp;
-static String topicActualTimeRemaining;
-static String topicYouCanShowerNow;
-
-static unsigned long lastMqttPublishMs = 0;
+static MqttTopicTable mqttTopics; // all topic strings, rebuilt only when the base topic changes
+using MT = MqttTopic;
+static MqttDispatcher mqttDispatch; // inbound topic suffix -> typed handler, built once in setup
+
+// Topics we listen on (BoilerTimeMin is only mirrored, YouCanShowerPeriodMin is the inbound alias)
+static const MqttTopic SUBSCRIBED_TOPICS[] = {
+    MT::SetShowerTime,
+    MT::WillShower,
+    MT::BoilerEnabled,
+    MT::OnThreshold,
+    MT::OffThreshold,
+    MT::StopTimerOnTarget,
+    MT::OncePerPeriod,
+    MT::YouCanShowerPeriodMin,
+    MT::Save,
+};
 
 static Ticker displayTicker;
-static Ticker TempReadTicker;
+
+// Adapters binding the pure control core to IO, clock and MQTT
+class IoBoilerRelay : public BoilerRelay
+{
+public:
+    bool get() const override { return ioManager.getState(IO_BOILER_ID); }
+    void set(bool on) override
+    {
+        ioManager.setState(IO_BOILER_ID, on);
+        requestStatePublish();
+    }
+};
+
+class ArduinoBoilerClock : public BoilerClock
+{
+public:
+    uint32_t millis() const override { return ::millis(); }
+    int64_t epochSeconds() const override { return static_cast<int64_t>(time(nullptr)); }
+};
+
+class MqttBoilerEvents : public BoilerEvents
+{
+public:
+    void onWillShowerCleared() override
+    {
+        if (mqtt.isConnected() && mqttTopics.ready())
+        {
+            mqtt.publish(mqttTopics.get(MT::WillShower), "0", true);
+        }
+    }
+
+    void onAlarmChanged(bool active, float temperature) override
+    {
+        lmg.log(LL::Error, "Temperature %.1f°C -> %s", temperature, active ? "HEATER ON" : "HEATER OFF");
+    }
+
+    void onForcedHeatingStart(int minutes) override
+    {
+        lmg.log(LL::Warn, "Under-temperature alarm active -> starting heating timer: %d min", minutes);
+    }
+
+    void onEarlyStop(float temperature, float marginC) override
+    {
+        lmg.log(LL::Info, "Early stop at %.1f°C (expected overshoot %.1f°C)", temperature, marginC);
+    }
+};
+
+// Session log segments as "/sessions/<id>.bin" files on the LittleFS partition
+class LittleFsSessionStorage : public SessionLogStorage
+{
+public:
+    static constexpr const char *DIR = "/sessions";
+
+    uint8_t listSegments(uint32_t *ids, uint8_t maxIds) override
+    {
+        File dir = LittleFS.open(DIR);
+        if (!dir || !dir.isDirectory())
+        {
+            return 0;
+        }
+        uint8_t n = 0;
+        for (File f = dir.openNextFile(); f && n < maxIds; f = dir.openNextFile())
+        {
+            ids[n++] = static_cast<uint32_t>(strtoul(f.name(), nullptr, 16));
+        }
+        return n;
+    }
+
+    size_t segmentSize(uint32_t id) override
+    {
+        File f = LittleFS.open(path(id), FILE_READ);
+        return f ? f.size() : 0;
+    }
+
+    bool append(uint32_t id, const uint8_t *data, size_t len) override
+    {
+        File f = LittleFS.open(path(id), FILE_APPEND);
+        return f && f.write(data, len) == len;
+    }
+
+    bool read(uint32_t id, size_t offset, uint8_t *data, size_t len) override
+    {
+        File f = LittleFS.open(path(id), FILE_READ);
+        return f && f.seek(offset) && f.read(data, len) == len;
+    }
+
+    bool remove(uint32_t id) override { return LittleFS.remove(path(id)); }
+
+private:
+    const char *path(uint32_t id)
+    {
+        snprintf(path_, sizeof(path_), "%s/%08lx.bin", DIR, static_cast<unsigned long>(id));
+        return path_;
+    }
+
+    char path_[32];
+};
+
+static IoBoilerRelay boilerRelay;
+static ArduinoBoilerClock boilerClock;
+static MqttBoilerEvents boilerEvents;
+static BoilerController boiler(boilerRelay, boilerClock, boilerEvents); // temperature, timer and shower request live here
+static TankModel tankModel; // learned heating/cooling rates and overshoot of the control sensor
+static HistoryRing history;  // delta-encoded temperature/relay samples, served from /history.*
+static SemaphoreHandle_t historyLock = nullptr; // loop() appends, the async web task streams
+static LittleFsSessionStorage sessionStorage;
+static SessionLog sessionLog(sessionStorage); // heating sessions, survives reboots/OTA
+static SessionTracker sessionTracker;
+static SemaphoreHandle_t sessionLock = nullptr; // guards sessionLog (and sessionStorage's path buffer)
+static bool sessionLogReady = false;
+static HeatSchedule heatSchedule;         // compiled from scheduleSettings.plan
+static String compiledPlan;               // plan text heatSchedule was built from
+static uint32_t scheduleCheckedMinute = 0; // epoch minute of the last schedule evaluation
+static uint32_t scheduleFiredMinute = 0;   // epoch minute of the target that last started heating
+static PreheatModel preheatModel;           // heat-up minutes vs. start temperature, from the session log
+static constexpr uint8_t PREHEAT_SEED_SESSIONS = 50; // newest logged sessions replayed at boot
+static constexpr float PREHEAT_MARGIN_MIN = 5.0f;    // safety added to the learned heat-up time
+static bool preheatPending = false;         // scheduled pre-heat waiting to reach offThreshold
+static float preheatEstimateMin = -1.0f;    // estimate used for the last scheduled start
+static int preheatErrorMin = 0;             // last realised error: + = target reached late
+static bool preheatErrorKnown = false;
 
 // globale helpers variables
-float temperature = 70.0;    // current temperature in Celsius
-int boilerTimeRemaining = 0; // remaining time for boiler in SECONDS
 bool boilerState = false;    // current state of the heater (on/off)
 
 static bool displayActive = true; // flag to indicate if the display is active
+static bool displayPanelOn = true; // SSD1306 DISPLAYON/OFF, applied by the display renderer
+
+// Immutable input for one display frame, handed to the display task through a mailbox
+struct DisplaySnapshot
+{
+    float temperature;
+    int32_t timeRemainingSec;
+    bool relayOn;
+    bool active;  // render fields (false = blank frame)
+    bool panelOn; // panel power
+
+    bool operator==(const DisplaySnapshot &o) const
+    {
+        return temperature == o.temperature && timeRemainingSec == o.timeRemainingSec && relayOn == o.relayOn &&
+               active == o.active && panelOn == o.panelOn;
+    }
+};
+static SnapshotMailbox<DisplaySnapshot> displayMailbox;
+
+// Control state as seen from other tasks (web/AsyncTCP callbacks, display core). The loop task
+// is the only writer (publishControlState() after each scheduler pass); readers copy it wait-free
+// instead of calling into BoilerController/IOManager while the loop is changing them.
+struct ControlState
+{
+    float temperature;
+    float rawTemperature; // NAN = no reading
+    int32_t timeRemainingSec;
+    bool relayOn;
+    bool sensorFault;
+    bool willShower;
+    bool canShower;
+
+    // Tank/pre-heat model and relay statistics for the live cards
+    int32_t etaSec; // -1 = learning
+    float heatRate; // 0 = learning
+    float coolRate; // 0 = learning
+    float overshootC;
+    float preheatEstMin; // -1 = learning
+    int32_t preheatErrMin;
+    uint32_t earlyStops;
+    uint32_t switches;
+    uint32_t starts;
+    uint32_t startsHour;
+    uint32_t onTimeSec;
+    uint32_t deferred;
+
+    bool operator==(const ControlState &o) const
+    {
+        // NAN != NAN would republish every pass; compare the raw value through isnan
+        const bool rawSame = (isnan(rawTemperature) && isnan(o.rawTemperature)) || rawTemperature == o.rawTemperature;
+        return temperature == o.temperature && rawSame && timeRemainingSec == o.timeRemainingSec &&
+               relayOn == o.relayOn && sensorFault == o.sensorFault && willShower == o.willShower &&
+               canShower == o.canShower && etaSec == o.etaSec && heatRate == o.heatRate &&
+               coolRate == o.coolRate && overshootC == o.overshootC && preheatEstMin == o.preheatEstMin &&
+               preheatErrMin == o.preheatErrMin && earlyStops == o.earlyStops && switches == o.switches &&
+               starts == o.starts && startsHour == o.startsHour && onTimeSec == o.onTimeSec &&
+               deferred == o.deferred;
+    }
+};
+static Seqlock<ControlState> controlState;
+static TaskHandle_t displayTaskHandle = nullptr;
+static DisplayDirtyTracker displayDirty; // changed SSD1306 page/column spans, shadow of the panel
+static constexpr uint8_t DISPLAY_I2C_CHUNK = 16; // data bytes per I2C transaction
 
-static bool globalAlarmState = false; // Global alarm state for temperature monitoring
 static constexpr char TEMP_ALARM_ID[] = "AL_Status";
 static constexpr char SENSOR_FAULT_ALARM_ID[] = "SF_Status";
 static bool sensorFaultState = false; // Global alarm state for sensor fault monitoring
 
-static unsigned long lastDisplayUpdate = 0;             // Non-blocking display update management
-static const unsigned long displayUpdateInterval = 100; // Update display every 100ms
 static const unsigned long resetHoldDurationMs = 3000;  // Require 3s hold to factory reset
 // DS18B20 globals
 static OneWire *oneWireBus = nullptr;
 static DallasTemperature *ds18 = nullptr;
+static TempSensorReader tempReader; // non-blocking request/collect pipeline, driven from loop()
+static float sensorTempsC[TempSensorReader::MAX_SENSORS] = {NAN, NAN, NAN}; // corrected, NAN = fault/missing
+static TempFilter tempFilter;  // median/EMA/rate limit between sensor 1 and the control
+static SensorModeStats sensorModes; // conversion time and noise per resolution/oversampling mode
+static float rawTempC = NAN;   // sensor 1 with offset, before tempFilter
 static bool youCanShowerNow = false;           // derived status for MQTT/UI
-static bool willShowerRequested = false;       // unified flag for UI+MQTT 'I will shower'
 static bool didStartupMQTTPropagate = false;   // ensure one-time retained propagation
-static long lastYouCanShower1PeriodId = -1;    // period id when we last published a '1'
-static bool lastPublishedYouCanShower = false; // track last published state to allow publishing 0 transitions
+// loop() profiling
+struct LoopStages
+{
+    uint8_t wifi, io, sensor, web, alarm, display, mqtt, logging, publish, boiler, led, snapshot, command, persist, boot, total;
+};
+static LoopStages loopStages = {};
+static LoopProfiler loopProfiler([]() -> uint32_t
+                                 { return ESP.getCycleCount(); });
+#if BOILER_LOOP_PROFILER
+#define LOOP_STAGE(stage) LoopProfiler::Scope stageScope_##stage(loopProfiler, loopStages.stage)
+#else
+#define LOOP_STAGE(stage)
+#endif
+
+// loop() scheduling: tasks run on deadlines, loop() sleeps until the next one or an event wakeup
+static constexpr uint32_t POLL_INTERVAL_MS = 20;     // IO debounce, web, MQTT client, LED patterns
+static constexpr uint32_t DISPLAY_INTERVAL_MS = 100; // display refresh (skipped when nothing changed)
+static constexpr uint32_t ALARM_INTERVAL_MS = 1500;  // cross-field runtime alarms
+static constexpr uint32_t MAX_LOOP_SLEEP_MS = 1000;  // upper bound for a single idle wait
+static constexpr uint32_t SNAPSHOT_INTERVAL_MS = 250; // runtime snapshot change check
+static LoopScheduler loopScheduler;
+static TaskHandle_t loopTaskHandle = nullptr;
+struct LoopTasks
+{
+    uint8_t io, net, sensor, display, alarm, publish, boiler, led, snapshot, command, persist, boot;
+};
+static LoopTasks loopTasks = {};
+
+// Inputs (MQTT, web UI, buttons) only enqueue a typed command; the command task applies them in
+// the loop, so control state has one writer and every input takes the same path.
+enum class CommandType : uint8_t
+{
+    SetShowerTime,   // i = minutes
+    WillShower,      // b
+    ToggleShower,    // shower button
+    SetEnabled,      // b
+    SetOnThreshold,  // f
+    SetOffThreshold, // f
+    SetShowerPeriod, // i = minutes
+    SetStopOnTarget, // b
+    SetOncePerPeriod, // b
+    Save,
+};
+enum class CommandSource : uint8_t
+{
+    Mqtt,
+    Web,
+    Button,
+};
+struct BoilerCommand
+{
+    CommandType type;
+    CommandSource source;
+    bool b;
+    int32_t i;
+    float f;
+    uint32_t queuedMs;
+};
+static CommandQueue<BoilerCommand, 16> commandQueue;
+static uint32_t commandsHandled = 0;
+static uint32_t commandLatencyLastMs = 0;
+static uint32_t commandLatencyMaxMs = 0;
+
+// Settings that MQTT can change. The Save command no longer rewrites every setting: only keys
+// whose value differs from flash are written, after a debounce window that further changes and
+// saves extend (capped, so a spamming script still gets its values stored).
+enum PersistKey : uint8_t
+{
+    PK_ENABLED,
+    PK_ON_THRESHOLD,
+    PK_OFF_THRESHOLD,
+    PK_BOILER_TIME,
+    PK_STOP_ON_TARGET,
+    PK_ONCE_PER_PERIOD,
+    PK_COUNT
+};
+static constexpr uint32_t PERSIST_DEBOUNCE_MS = 3000;
+static constexpr uint32_t PERSIST_MAX_DELAY_MS = 30000;
+static PersistTracker settingsPersist(PK_COUNT, PERSIST_DEBOUNCE_MS, PERSIST_MAX_DELAY_MS);
+static std::atomic<uint32_t> settingsChangedMask{0}; // set by setting callbacks on any task
+static bool applyingCommand = false;                 // loop task only: inside applyCommand()
+
+// Staged boot: setup() only runs the control path (settings, relay, first reading, decision).
+// The remaining stages are started by the boot loop task, one per pass, so sensor and boiler
+// tasks keep running on real data while the display, flash and WiFi come up.
+enum BootStage : uint8_t
+{
+    BS_SETTINGS,
+    BS_IO,
+    BS_SENSOR,
+    BS_CONTROL,
+    BS_DISPLAY,
+    BS_STORAGE,
+    BS_GUI,
+    BS_NETWORK,
+    BS_COUNT
+};
+static const char *const BOOT_STAGE_NAMES[BS_COUNT] = {"settings", "io", "sensor", "control", "display", "storage", "gui", "network"};
+static BootTimeline bootTimeline(BOOT_STAGE_NAMES, BS_COUNT);
+static char bootSummary[160] = "-";
+static constexpr uint8_t BOOT_SENSOR_BITS = 10;          // first conversion ~190 ms instead of 750 ms at 12 bit
+static constexpr uint32_t BOOT_SENSOR_TIMEOUT_MS = 1000; // give up and let the sensor task retry
+static bool displayReady = false;
+static bool networkReady = false;
+
+// Web runtime view: serialized in the loop once per change, copied out by the API server task.
+// The live card lambdas read the preformatted strings instead of formatting per poll.
+static TextSnapshot<512> runtimeJson;
+static TextSnapshot<16> timeLeftText;   // "h:mm:ss"
+static TextSnapshot<32> nextShowerText; // "Mo 06:30 (in 3:10)" or "-"
+static uint32_t runtimeSnapshotBuilds = 0;
+static uint32_t runtimeSnapshotServed = 0;
+
+// Fields of the runtime view; each is integer coded so DeltaTracker can diff them.
+enum RuntimeField : uint8_t
+{
+    RF_ENABLED,
+    RF_RELAY,
+    RF_CAN_SHOWER,
+    RF_WILL_SHOWER,
+    RF_SENSOR_FAULT,
+    RF_TEMP,      // centi-°C
+    RF_TEMP_RAW,  // centi-°C, INT32_MIN = no reading
+    RF_TIME_LEFT, // seconds
+    RF_SET_MIN,
+    RF_ETA,         // seconds, -1 = learning
+    RF_NEXT_SHOWER, // epoch minute the text was made for
+    RF_COUNT
+};
+static constexpr uint32_t RUNTIME_ALL_FIELDS = (1u << RF_COUNT) - 1u;
+static constexpr uint32_t EVENT_MIN_INTERVAL_MS = 1000; // SSE: at most one delta per second
+static int32_t runtimeValues[RF_COUNT] = {};
+static DeltaTracker runtimeDelta(RF_COUNT, EVENT_MIN_INTERVAL_MS);
+static AsyncEventSource runtimeEvents("/events"); // on apiServer
+static uint32_t runtimeEventsSent = 0;
+
+// Change-driven state publishing: per-topic cache with deadbands and a max-silence heartbeat
+enum PublishSlot : uint8_t
+{
+    PUB_TEMPERATURE,
+    PUB_TIME_REMAINING,
+    PUB_ACTUAL_STATE,
+    PUB_CAN_SHOWER,
+    PUB_TIME_TO_TARGET,
+    PUB_TEMPERATURE_RAW,
+};
+static constexpr uint32_t PUBLISH_COALESCE_MS = 50; // changes within this window go out as one burst
+static PublishCache publishCache;
+static bool publishPending = false;
+static uint32_t stateSeq = 0; // sequence number of the JSON State message
+
 // MQTT status monitoring
 static unsigned long lastMqttStatusLog = 0;
 static bool lastMqttConnectedState = false;
@@ -158,7 +578,7 @@ static bool lastMqttConnectedState = false;
 
 void setup()
 {
-
+    bootTimeline.start(BS_SETTINGS, millis());
     setupLogging();
     lmg.scopedTag("SETUP");
     lmg.log("System setup start...");
@@ -180,67 +600,327 @@ void setup()
     setupMQTT();
 
     ConfigManager.loadAll();
+    markSettingsStored();
 
-    setupNetworkDefaults();
-    mqtt.attach(ConfigManager);
-    ioManager.begin();
+    setupNetworkDefaults(); // may restart on first boot, before the relay is driven
+    bootTimeline.finish(BS_SETTINGS, millis());
 
-    updateMqttTopics();
-    setupMqttCallbacks();
+    bootTimeline.start(BS_IO, millis());
+    ioManager.begin();
     setBoilerState(false);
+    bootTimeline.finish(BS_IO, millis());
 
-    setupGUI();
-
-    SetupStartDisplay();
-    ShowDisplay();
+    bootTimeline.start(BS_SENSOR, millis());
     setupTempSensor();
-    
-    applyWiFiMacPriority();
-    ConfigManager.startWebServer();
-
-    lmg.log("System setup completed.");
+    readFirstTemperature();
+    bootTimeline.finish(BS_SENSOR, millis());
+
+    bootTimeline.start(BS_CONTROL, millis());
+    historyLock = xSemaphoreCreateMutex();
+    UpdateBoilerAlarmState();
+    handeleBoilerState(false); // the relay follows the first reading instead of waiting a readInterval
+    publishControlState();     // readers on the web task never see the zeroed default
+    setupLoopProfiler();
+    setupLoopScheduler();
+    bootTimeline.finish(BS_CONTROL, millis());
+
+    lmg.log("Control ready after %lu ms (%.2f°C, relay %s); display and network follow from loop()",
+            (unsigned long)millis(), boiler.temperature(), getBoilerState() ? "on" : "off");
 }
 
 void loop()
 {
     lmg.scopedTag("loop");
+    {
+        LOOP_STAGE(total);
+        loopScheduler.runDue(millis());
+        publishControlState();
+    }
+
+    // Sleep until the next deadline; wakeLoop() (web/MQTT/IO/sensor events) ends the wait early.
+    const uint32_t waitMs = min<uint32_t>(loopScheduler.msUntilNext(millis()), MAX_LOOP_SLEEP_MS);
+    if (waitMs > 0)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+    }
+}
+
+//----------------------------------------
+// LOOP TASKS
+//----------------------------------------
+
+static void setupLoopScheduler()
+{
+    loopTaskHandle = xTaskGetCurrentTaskHandle(); // setup() runs on the loop task
+    const uint32_t now = millis();
+    loopTasks.io = loopScheduler.add("io", POLL_INTERVAL_MS, taskIo, now);
+    loopTasks.net = loopScheduler.add("net", POLL_INTERVAL_MS, taskNet, now);
+    loopTasks.sensor = loopScheduler.add("sensor", 0, taskSensor, now);
+    loopTasks.display = loopScheduler.add("display", DISPLAY_INTERVAL_MS, taskDisplay, now);
+    loopTasks.alarm = loopScheduler.add("alarm", ALARM_INTERVAL_MS, taskAlarm, now);
+    loopTasks.publish = loopScheduler.add("publish", 1000, taskPublish, now);
+    loopTasks.boiler = loopScheduler.add("boiler", BoilerController::CHECK_INTERVAL_MS, taskBoiler, now);
+    loopTasks.led = loopScheduler.add("led", POLL_INTERVAL_MS, taskLed, now);
+    loopTasks.snapshot = loopScheduler.add("snapshot", SNAPSHOT_INTERVAL_MS, taskSnapshot, now);
+    loopTasks.command = loopScheduler.add("command", 0, taskCommand, now); // runs when postCommand() wakes it
+    loopTasks.persist = loopScheduler.add("persist", 0, taskPersist, now);  // scheduled by the Save command
+    loopTasks.boot = loopScheduler.add("boot", 0, taskBoot, now);           // lazy boot stages, then idle
+}
+
+// Run a task on the next pass and wake the loop task if it is sleeping. Callable from any task.
+static void wakeLoop(uint8_t task)
+{
+    loopScheduler.trigger(task);
+    if (loopTaskHandle)
+    {
+        xTaskNotifyGive(loopTaskHandle);
+    }
+}
 
-    ConfigManager.getWiFiManager().update();
+static void taskIo()
+{
+    LOOP_STAGE(io);
     boilerState = getBoilerState();
     ioManager.update();
+}
 
-    ConfigManager.handleClient();
-    alarmManager.update();
+static void taskNet()
+{
+    if (!networkReady)
+    {
+        LOOP_STAGE(logging);
+        lmg.loop();
+        return;
+    }
+    {
+        LOOP_STAGE(wifi);
+        ConfigManager.getWiFiManager().update();
+    }
+    {
+        LOOP_STAGE(web);
+        ConfigManager.handleClient();
+    }
+    {
+        LOOP_STAGE(mqtt);
+        mqtt.loop();
+    }
+    {
+        LOOP_STAGE(logging);
+        lmg.loop();
+    }
+}
+
+static void taskSensor()
+{
+    LOOP_STAGE(sensor);
+    static uint32_t lastRescans = 0;
+    const uint32_t now = millis();
+    const bool sampled = tempReader.update(now);
+    if (tempReader.rescanCount() != lastRescans)
+    {
+        lastRescans = tempReader.rescanCount();
+        lmg.logTag(LL::Info, "TEMP", "Bus searched again: %u of %u probe(s) found", (unsigned)tempReader.presentCount(),
+                   (unsigned)tempReader.sensorCount());
+        for (uint8_t i = 0; i < tempReader.sensorCount(); ++i)
+        {
+            if (!tempReader.present(i))
+            {
+                const uint8_t *a = tempReader.address(i);
+                lmg.logTag(LL::Error, "TEMP", "Sensor %u (ROM %02X%02X%02X%02X%02X%02X%02X%02X) missing", (unsigned)(i + 1),
+                           a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+            }
+        }
+    }
+    if (sampled)
+    {
+        applyExtraSensorReadings();
+        const float raw0 = tempReader.lastRawC(0);
+        if (sensorModes.bits() != tempReader.resolutionBits() || sensorModes.oversample() != tempReader.oversample())
+        {
+            sensorModes.select(tempReader.resolutionBits(), tempReader.oversample());
+        }
+        if (raw0 <= -127.0f || raw0 >= 85.0f)
+        {
+            sensorModes.addFault();
+        }
+        else
+        {
+            sensorModes.addSample(tempReader.lastSampleMs(), raw0);
+        }
+        applyTempReading(raw0); // sensor 1 drives the control
+        if (!sensorFaultState)
+        {
+            tankModel.addSample(now, boiler.temperature(), getBoilerState());
+            boiler.setStopMargin(tankModel.overshootKnown() ? tankModel.overshootC() : 0.0f);
+            recordHistory(now);
+        }
+        loopScheduler.trigger(loopTasks.display);
+        requestStatePublish();
+    }
+    loopScheduler.scheduleAt(loopTasks.sensor, tempReader.nextActionMs(now));
+}
 
-    // Non-blocking display updates
-    if (millis() - lastDisplayUpdate > displayUpdateInterval)
+// Post a snapshot when something visible changed; rendering happens in the display task.
+static void taskDisplay()
+{
+    LOOP_STAGE(display);
+    if (!displayReady)
+    {
+        return; // the boot task posts the first frame once the panel is initialised
+    }
+    static DisplaySnapshot lastPosted = {};
+    static bool posted = false;
+
+    const DisplaySnapshot snap = {
+        boiler.temperature(),
+        boiler.timeRemaining(),
+        boilerState,
+        displayActive,
+        displayPanelOn,
+    };
+    if (posted && snap == lastPosted)
     {
-        lastDisplayUpdate = millis();
-        WriteToDisplay();
+        return;
     }
+    lastPosted = snap;
+    posted = true;
 
-    // Evaluate cross-field runtime alarms periodically (cheap doc build ~ small JSON)
-    static unsigned long lastAlarmEval = 0;
-    if (millis() - lastAlarmEval > 1500)
+    if (!displayTaskHandle)
     {
-        lastAlarmEval = millis();
-        UpdateBoilerAlarmState();
+        WriteToDisplay(snap); // no display task: render inline
+        return;
     }
+    displayMailbox.publish(snap);
+    xTaskNotifyGive(displayTaskHandle);
+}
 
-    mqtt.loop();
-    lmg.loop();
+static void taskAlarm()
+{
+    LOOP_STAGE(alarm);
+    alarmManager.update();
+    UpdateBoilerAlarmState();
+}
 
+static void taskPublish()
+{
+    LOOP_STAGE(publish);
     publishMqttStateIfNeeded();
+}
 
+static void taskBoiler()
+{
+    LOOP_STAGE(boiler);
     handeleBoilerState(false);
+    trackSession();
+    requestStatePublish(); // timer countdown; the cache decides whether anything goes out
+}
 
+static void taskLed()
+{
+    LOOP_STAGE(led);
     updateStatusLED();
-
     cm::helpers::PulseOutput::loopAll();
+}
+
+static void taskSnapshot()
+{
+    LOOP_STAGE(snapshot);
+    updateRuntimeSnapshot();
+}
+
+// Lazy boot: one stage per pass, then the task stays idle.
+static void taskBoot()
+{
+    LOOP_STAGE(boot);
+    lmg.scopedTag("BOOT");
+    if (!bootTimeline.finished(BS_DISPLAY))
+    {
+        bootTimeline.start(BS_DISPLAY, millis());
+        SetupStartDisplay();
+        startDisplayTask();
+        displayReady = true;
+        ShowDisplay();
+        bootTimeline.finish(BS_DISPLAY, millis());
+    }
+    else if (!bootTimeline.finished(BS_STORAGE))
+    {
+        bootTimeline.start(BS_STORAGE, millis());
+        setupSessionLog();
+        bootTimeline.finish(BS_STORAGE, millis());
+    }
+    else if (!bootTimeline.finished(BS_GUI))
+    {
+        bootTimeline.start(BS_GUI, millis());
+        mqtt.attach(ConfigManager);
+        updateMqttTopics();
+        setupMqttDispatch();
+        setupMqttCallbacks();
+        setupGUI();
+        bootTimeline.finish(BS_GUI, millis());
+    }
+    else if (!bootTimeline.finished(BS_NETWORK))
+    {
+        bootTimeline.start(BS_NETWORK, millis());
+        applyWiFiMacPriority();
+        ConfigManager.startWebServer();
+        setupApiServer();
+        networkReady = true;
+        bootTimeline.finish(BS_NETWORK, millis());
+    }
+
+    if (!bootTimeline.complete())
+    {
+        loopScheduler.trigger(loopTasks.boot); // next stage on the next pass
+        return;
+    }
+    bootTimeline.format(bootSummary, sizeof(bootSummary));
+    lmg.log(LL::Info, "Boot complete after %lu ms, control ready at %lu ms: %s",
+            (unsigned long)bootTimeline.doneAtMs(BS_NETWORK), (unsigned long)bootTimeline.doneAtMs(BS_CONTROL), bootSummary);
+    lmg.log("System setup completed.");
+}
+
+// Safe from any task: the copy is local, and the double-buffered seqlock hands a reader that
+// preempted the writer the previous state instead of making it give up.
+static ControlState readControlState()
+{
+    return controlState.load(ControlState{});
+}
 
-    delay(10);
+static void publishControlState()
+{
+    static ControlState last = {};
+    static bool published = false;
+    const ControlState now = {
+        boiler.temperature(),
+        rawTempC,
+        boiler.timeRemaining(),
+        getBoilerState(),
+        sensorFaultState,
+        boiler.willShowerRequested(),
+        boiler.canShowerNow(),
+        tankModel.secondsToTarget(boiler.temperature(), boilerSettings.offThreshold->get()),
+        tankModel.heatingKnown() ? tankModel.heatingRate() : 0.0f,
+        tankModel.coolingKnown() ? tankModel.coolingRate() : 0.0f,
+        tankModel.overshootC(),
+        preheatModel.estimateMinutes(boiler.temperature()),
+        preheatErrorKnown ? preheatErrorMin : 0,
+        boiler.earlyStopCount(),
+        boiler.switchCount(),
+        boiler.startCount(),
+        boiler.startsLastHour(),
+        boiler.onTimeSec(),
+        boiler.deferredCount(),
+    };
+    if (published && now == last)
+    {
+        return; // keep the sequence quiet so readers rarely retry
+    }
+    controlState.store(now);
+    last = now;
+    published = true;
 }
 
+
 //----------------------------------------
 // PROJECT FUNCTIONS
 //----------------------------------------
@@ -254,6 +934,8 @@ void setupGUI()
     ConfigManager.addSettingsGroup("I2C", "I2C", "I2C Bus", 40);
     ConfigManager.addSettingsPage("Boiler", 50);
     ConfigManager.addSettingsGroup("Boiler", "Boiler", "Boiler Control", 50);
+    ConfigManager.addSettingsPage("Schedule", 55);
+    ConfigManager.addSettingsGroup("Schedule", "Schedule", "Heating Schedule", 55);
     ConfigManager.addSettingsPage("Display", 60);
     ConfigManager.addSettingsGroup("Display", "Display", "Display Options", 60);
     ConfigManager.addSettingsPage("Temp Sensor", 70);
@@ -262,7 +944,7 @@ void setupGUI()
 
     // add runtime values for the GUI
     ConfigManager.getRuntime().addRuntimeProvider("Boiler", [](JsonObject &o)
-                                                  { o["Bo_TimeLeft"] = boilerTimeRemaining; });
+                                                  { o["Bo_TimeLeft"] = readControlState().timeRemainingSec; });
 
     auto boilerCard = ConfigManager.liveGroup("Boiler")
                           .page("Boiler", 10)
@@ -274,20 +956,17 @@ void setupGUI()
         .order(1);
 
     boilerCard.value("Bo_EN", []()
-                     { return getBoilerState(); })
+                     { return readControlState().relayOn; })
         .label("Relay On")
         .order(2);
 
     boilerCard.value("Bo_CanShower", []()
-                     {
-            const bool canShower = (temperature >= boilerSettings.offThreshold->get()) && getBoilerState();
-            youCanShowerNow = canShower;
-            return canShower; })
+                     { return readControlState().canShower; })
         .label("You can shower now")
         .order(5);
 
     boilerCard.value("Bo_Temp", []()
-                     { return temperature; })
+                     { return readControlState().temperature; })
         .label("Temperature")
         .unit("°C")
         .precision(1)
@@ -296,12 +975,8 @@ void setupGUI()
 
     boilerCard.value("Bo_TimeLeftFmt", []()
                      {
-            int total = max(0, boilerTimeRemaining);
-            int h = total / 3600;
-            int m = (total % 3600) / 60;
-            int s = total % 60;
-            char buf[12];
-            snprintf(buf, sizeof(buf), "%d:%02d:%02d", h, m, s);
+            char buf[16];
+            timeLeftText.read(buf, sizeof(buf));
             return String(buf); })
         .label("Time remaining")
         .order(21);
@@ -313,13 +988,110 @@ void setupGUI()
         .precision(0)
         .order(22);
 
+    boilerCard.value("Bo_NextShower", []()
+                     {
+            char buf[32];
+            nextShowerText.read(buf, sizeof(buf));
+            return String(buf); })
+        .label("Next planned shower")
+        .order(24);
+
+    boilerCard.value("Bo_Eta", []()
+                     {
+            const int32_t eta = readControlState().etaSec;
+            return eta < 0 ? -1.0f : eta / 60.0f; })
+        .label("Predicted heat-up to target (-1 = learning)")
+        .unit("min")
+        .precision(1)
+        .order(23);
+
+    auto modelCard = ConfigManager.liveGroup("Boiler")
+                         .page("Boiler", 10)
+                         .card("Tank model", 30);
+
+    modelCard.value("Tm_HeatRate", []()
+                    { return readControlState().heatRate; })
+        .label("Heating rate")
+        .unit("°C/min")
+        .precision(2)
+        .order(1);
+
+    modelCard.value("Tm_CoolRate", []()
+                    { return readControlState().coolRate; })
+        .label("Cooling rate")
+        .unit("°C/min")
+        .precision(3)
+        .order(2);
+
+    modelCard.value("Tm_Overshoot", []()
+                    { return readControlState().overshootC; })
+        .label("Overshoot after stop")
+        .unit("°C")
+        .precision(1)
+        .order(3);
+
+    modelCard.value("Tm_EarlyStops", []()
+                    { return (int)readControlState().earlyStops; })
+        .label("Early stops")
+        .precision(0)
+        .order(4);
+
+    modelCard.value("Tm_PreheatEst", []()
+                    { return readControlState().preheatEstMin; })
+        .label("Heat-up estimate from now (-1 = learning)")
+        .unit("min")
+        .precision(0)
+        .order(5);
+
+    modelCard.value("Tm_PreheatErr", []()
+                    { return (int)readControlState().preheatErrMin; })
+        .label("Last pre-heat error (+ = late)")
+        .unit("min")
+        .precision(0)
+        .order(6);
+
+    auto relayCard = ConfigManager.liveGroup("Boiler")
+                         .page("Boiler", 10)
+                         .card("Relay", 40);
+
+    relayCard.value("Rl_Switches", []()
+                    { return (int)readControlState().switches; })
+        .label("Switch operations")
+        .precision(0)
+        .order(1);
+
+    relayCard.value("Rl_Starts", []()
+                    { return (int)readControlState().starts; })
+        .label("Burner starts")
+        .precision(0)
+        .order(2);
+
+    relayCard.value("Rl_StartsHour", []()
+                    { return (int)readControlState().startsHour; })
+        .label("Starts in the last hour")
+        .precision(0)
+        .order(3);
+
+    relayCard.value("Rl_OnTime", []()
+                    { return readControlState().onTimeSec / 3600.0f; })
+        .label("Burner on time")
+        .unit("h")
+        .precision(2)
+        .order(4);
+
+    relayCard.value("Rl_Deferred", []()
+                    { return (int)readControlState().deferred; })
+        .label("Switches held back (dwell/budget)")
+        .precision(0)
+        .order(5);
+
     boilerCard.stateButton(
                   "sb_mode",
                   "Will Shower",
                   []()
-                  { return willShowerRequested; },
+                  { return readControlState().willShower; },
                   [](bool v)
-                  { handleShowerRequest(v); },
+                  { postCommand(CommandType::WillShower, CommandSource::Web, v); },
                   false,
                   "On",
                   "Off")
@@ -333,7 +1105,7 @@ void setupGUI()
         TEMP_ALARM_ID,
         "Under Temperature Alarm (Boiler Error?)",
         []()
-        { return globalAlarmState; },
+        { return boiler.alarmActive(); },
         cm::AlarmKind::DigitalActive,
         true,
         cm::AlarmSeverity::Alarm);
@@ -376,145 +1148,486 @@ void setupGUI()
         .unit("°C")
         .precision(1)
         .order(102);
-}
 
-void UpdateBoilerAlarmState()
-{
-    lmg.scopedTag("UpdateBoilerAlarmState");
-    bool previousState = globalAlarmState;
+    auto sensorCard = ConfigManager.liveGroup("Boiler")
+                          .page("Boiler", 10)
+                          .card("Sensor", 20);
 
-    if (globalAlarmState)
-    {
-        if (temperature >= boilerSettings.onThreshold->get() + 2.0f)
-        {
-            globalAlarmState = false;
-        }
-    }
-    else
-    {
-        if (temperature <= boilerSettings.onThreshold->get())
-        {
-            globalAlarmState = true;
-        }
-    }
+    sensorCard.value("Ts_ConvMs", []()
+                     { return (int)tempReader.lastConversionMs(); })
+        .label("Conversion time")
+        .unit("ms")
+        .precision(0)
+        .order(1);
 
-    if (globalAlarmState != previousState)
-    {
-        lmg.log(LL::Error, "Temperature %.1f°C -> %s",
-                temperature, globalAlarmState ? "HEATER ON" : "HEATER OFF");
-        handeleBoilerState(true); // Force boiler if the temperature is too low
-    }
-}
+    sensorCard.value("Ts_BusyUs", []()
+                     { return (int)tempReader.lastBusyUs(); })
+        .label("CPU busy (last)")
+        .unit("us")
+        .precision(0)
+        .order(2);
 
-void handeleBoilerState(bool forceON)
-{
-    lmg.scopedTag("handeleBoilerState");
-    static unsigned long lastBoilerCheck = 0;
-    unsigned long now = millis();
+    sensorCard.value("Ts_BusyMaxUs", []()
+                     { return (int)tempReader.maxBusyUs(); })
+        .label("CPU busy (max)")
+        .unit("us")
+        .precision(0)
+        .order(3);
 
-    if (now - lastBoilerCheck >= 1000) // Check every second
-    {
-        lastBoilerCheck = now;
-        const bool stopOnTarget = boilerSettings.stopTimerOnTarget->get();
-        const int prevTime = boilerTimeRemaining;
+    sensorCard.value("Ts_T1", []()
+                     { return sensorTempsC[0]; })
+        .label("Sensor 1 (control)")
+        .unit("°C")
+        .precision(1)
+        .order(10);
 
-        // When we force-enable the boiler (e.g. due to under-temperature alarm),
-        // ensure we actually have a non-zero timer so the existing control logic can turn the relay on.
-        if (forceON && boilerTimeRemaining <= 0)
-        {
-            int mins = boilerSettings.boilerTimeMin->get();
-            if (mins <= 0)
-            {
-                mins = 1;
-            }
-            boilerTimeRemaining = mins * 60;
-            lmg.log(LL::Warn, "Under-temperature alarm active -> starting heating timer: %d min", mins);
-        }
+    sensorCard.value("Ts_T1Raw", []()
+                     { return readControlState().rawTemperature; })
+        .label("Sensor 1 unfiltered")
+        .unit("°C")
+        .precision(2)
+        .order(13);
 
-        // Temperature-based auto control: turn off when upper threshold reached, allow turn-on when below lower threshold
-        if (getBoilerState())
-        {
-            if (temperature >= boilerSettings.offThreshold->get())
-            {
-                setBoilerState(false);
-                if (stopOnTarget)
-                {
-                    boilerTimeRemaining = 0;
-                    if (willShowerRequested)
-                    {
-                        willShowerRequested = false;
-                        if (mqtt.isConnected() && !topicWillShower.isEmpty())
-                        {
-                            mqtt.publish(topicWillShower.c_str(), "0", true);
-                        }
-                    }
-                }
-            }
-        }
-        else
-        {
-            if ((boilerSettings.enabled->get() || forceON) && (temperature <= boilerSettings.onThreshold->get()) && (boilerTimeRemaining > 0))
-            {
-                setBoilerState(true);
-            }
-        }
+    sensorCard.value("Ts_Limited", []()
+                     { return (int)tempFilter.limitedCount(); })
+        .label("Rate-limited samples")
+        .precision(0)
+        .order(14);
+
+    sensorCard.value("Ts_T2", []()
+                     { return sensorTempsC[1]; })
+        .label("Sensor 2")
+        .unit("°C")
+        .precision(1)
+        .order(11);
+
+    sensorCard.value("Ts_T3", []()
+                     { return sensorTempsC[2]; })
+        .label("Sensor 3")
+        .unit("°C")
+        .precision(1)
+        .order(12);
+
+    sensorCard.value("Ts_Mode", []()
+                     {
+            char buf[24];
+            snprintf(buf, sizeof(buf), "%u-bit x%u", (unsigned)tempReader.resolutionBits(), (unsigned)tempReader.oversample());
+            return String(buf); })
+        .label("Read mode")
+        .order(4);
+
+    sensorCard.value("Ts_SampleMs", []()
+                     { return (int)tempReader.lastSampleMs(); })
+        .label("Sample time (all conversions)")
+        .unit("ms")
+        .precision(0)
+        .order(5);
+
+    sensorCard.value("Ts_Noise", []()
+                     { return sensorModes.current().noiseC; })
+        .label("Noise (1 sigma)")
+        .unit("°C")
+        .precision(3)
+        .order(6);
+
+    // One row per resolution, listing every oversampling factor that has been measured
+    auto modesCard = ConfigManager.liveGroup("Boiler")
+                         .page("Boiler", 10)
+                         .card("Sensor modes", 25);
+
+    modesCard.value("Sm_9", []()
+                    { return describeSensorModes(9); })
+        .label("9 bit (0.5 °C)")
+        .order(1);
+
+    modesCard.value("Sm_10", []()
+                    { return describeSensorModes(10); })
+        .label("10 bit (0.25 °C)")
+        .order(2);
+
+    modesCard.value("Sm_11", []()
+                    { return describeSensorModes(11); })
+        .label("11 bit (0.125 °C)")
+        .order(3);
+
+    modesCard.value("Sm_12", []()
+                    { return describeSensorModes(12); })
+        .label("12 bit (0.0625 °C)")
+        .order(4);
+
+    auto heapCard = ConfigManager.liveGroup("Perf")
+                        .page("Perf", 90)
+                        .card("Heap", 20);
+
+#if BOILER_HEAP_PROBE
+    heapCard.value("Hp_PubAllocs", []()
+                   { return (int)HeapProbe::lastAllocs(); })
+        .label("Allocs per publish (last)")
+        .precision(0)
+        .order(1);
+
+    heapCard.value("Hp_PubAllocsMax", []()
+                   { return (int)HeapProbe::maxAllocs(); })
+        .label("Allocs per publish (max)")
+        .precision(0)
+        .order(2);
+
+    heapCard.value("Hp_DirtyCycles", []()
+                   { return (int)HeapProbe::windowsWithAllocs(); })
+        .label("Publish cycles with allocs")
+        .precision(0)
+        .order(3);
+#endif
+
+    heapCard.value("Hp_FragPct", []()
+                   { return (int)HeapProbe::fragmentationPct(); })
+        .label("Heap fragmentation")
+        .unit("%")
+        .precision(0)
+        .order(4);
+
+    auto publishCard = ConfigManager.liveGroup("Perf")
+                           .page("Perf", 90)
+                           .card("MQTT publish", 30);
+
+    publishCard.value("Pub_Sent", []()
+                      { return (int)publishCache.sentCount(); })
+        .label("State messages sent")
+        .precision(0)
+        .order(1);
+
+    publishCard.value("Pub_Skipped", []()
+                      { return (int)publishCache.suppressedCount(); })
+        .label("Suppressed (unchanged)")
+        .precision(0)
+        .order(2);
+
+    auto displayCard = ConfigManager.liveGroup("Perf")
+                           .page("Perf", 90)
+                           .card("Display I2C", 40);
+
+    displayCard.value("Dp_Flushes", []()
+                      { return (int)displayDirty.flushCount(); })
+        .label("Flushes")
+        .precision(0)
+        .order(1);
+
+    displayCard.value("Dp_BytesSent", []()
+                      { return (int)displayDirty.bytesSent(); })
+        .label("Bytes sent")
+        .unit("B")
+        .precision(0)
+        .order(2);
+
+    displayCard.value("Dp_BytesSaved", []()
+                      { return (int)displayDirty.bytesSaved(); })
+        .label("Bytes saved vs full frame")
+        .unit("B")
+        .precision(0)
+        .order(3);
+
+    auto historyCard = ConfigManager.liveGroup("Perf")
+                           .page("Perf", 90)
+                           .card("History", 50);
+
+    historyCard.value("Hi_Samples", []()
+                      { return (int)history.sampleCount(); })
+        .label("Samples")
+        .precision(0)
+        .order(1);
+
+    historyCard.value("Hi_Span", []()
+                      { return history.sampleCount() ? (float)(history.newestTime() - history.oldestTime()) / 3600.0f : 0.0f; })
+        .label("Covered span")
+        .unit("h")
+        .precision(1)
+        .order(2);
+
+    historyCard.value("Hi_Bytes", []()
+                      { return (int)history.bytesUsed(); })
+        .label("Memory used")
+        .unit("B")
+        .precision(0)
+        .order(3);
+
+    auto sessionCard = ConfigManager.liveGroup("Perf")
+                           .page("Perf", 90)
+                           .card("Session log", 60);
+
+    sessionCard.value("Sl_Count", []()
+                      { return (int)sessionLog.size(); })
+        .label("Sessions")
+        .precision(0)
+        .order(1);
+
+    sessionCard.value("Sl_Pending", []()
+                      { return (int)sessionLog.pendingCount(); })
+        .label("Waiting for flash")
+        .precision(0)
+        .order(2);
+
+    sessionCard.value("Sl_Writes", []()
+                      { return (int)sessionLog.flashWrites(); })
+        .label("Flash writes")
+        .precision(0)
+        .order(3);
+
+    auto snapshotCard = ConfigManager.liveGroup("Perf")
+                            .page("Perf", 90)
+                            .card("Runtime snapshot", 70);
+
+    snapshotCard.value("Rs_Builds", []()
+                       { return (int)runtimeSnapshotBuilds; })
+        .label("Rebuilds")
+        .precision(0)
+        .order(1);
+
+    snapshotCard.value("Rs_Served", []()
+                       { return (int)runtimeSnapshotServed; })
+        .label("Requests served")
+        .precision(0)
+        .order(2);
+
+    snapshotCard.value("Rs_Retries", []()
+                       { return (int)runtimeJson.readRetries(); })
+        .label("Reader retries")
+        .precision(0)
+        .order(3);
+
+    snapshotCard.value("Rs_Clients", []()
+                       { return (int)runtimeEvents.count(); })
+        .label("SSE clients")
+        .precision(0)
+        .order(4);
+
+    snapshotCard.value("Rs_Events", []()
+                       { return (int)runtimeEventsSent; })
+        .label("SSE deltas sent")
+        .precision(0)
+        .order(5);
+
+    snapshotCard.value("Rs_Coalesced", []()
+                       { return (int)runtimeDelta.changesCoalesced(); })
+        .label("Changes coalesced")
+        .precision(0)
+        .order(6);
+
+    snapshotCard.value("Rs_StateRetries", []()
+                       { return (int)controlState.readRetries(); })
+        .label("Control state reader retries")
+        .precision(0)
+        .order(7);
+
+    auto commandCard = ConfigManager.liveGroup("Perf")
+                           .page("Perf", 90)
+                           .card("Command queue", 80);
+
+    commandCard.value("Cq_Handled", []()
+                      { return (int)commandsHandled; })
+        .label("Commands handled")
+        .precision(0)
+        .order(1);
+
+    commandCard.value("Cq_Dropped", []()
+                      { return (int)commandQueue.droppedCount(); })
+        .label("Dropped (queue full)")
+        .precision(0)
+        .order(2);
+
+    commandCard.value("Cq_HighWater", []()
+                      { return (int)commandQueue.highWater(); })
+        .label("Max depth")
+        .precision(0)
+        .order(3);
+
+    commandCard.value("Cq_LatencyLast", []()
+                      { return (int)commandLatencyLastMs; })
+        .label("Latency (last)")
+        .unit("ms")
+        .precision(0)
+        .order(4);
+
+    commandCard.value("Cq_LatencyMax", []()
+                      { return (int)commandLatencyMaxMs; })
+        .label("Latency (max)")
+        .unit("ms")
+        .precision(0)
+        .order(5);
+
+    auto persistCard = ConfigManager.liveGroup("Perf")
+                           .page("Perf", 90)
+                           .card("Settings persistence", 90);
+
+    persistCard.value("Ps_Writes", []()
+                      { return (int)settingsPersist.keyWrites(); })
+        .label("Keys written")
+        .precision(0)
+        .order(1);
+
+    persistCard.value("Ps_Avoided", []()
+                      { return (int)settingsPersist.writesAvoided(); })
+        .label("Flash writes avoided")
+        .precision(0)
+        .order(2);
+
+    persistCard.value("Ps_Dirty", []()
+                      { return (int)__builtin_popcount(settingsPersist.dirtyMask()); })
+        .label("Unsaved keys")
+        .precision(0)
+        .order(3);
+
+    auto bootCard = ConfigManager.liveGroup("Perf")
+                        .page("Perf", 90)
+                        .card("Boot timeline", 100);
+
+    bootCard.value("Bt_Control", []()
+                   { return (int)bootTimeline.doneAtMs(BS_CONTROL); })
+        .label("Control ready")
+        .unit("ms")
+        .precision(0)
+        .order(1);
+
+    bootCard.value("Bt_Sensor", []()
+                   { return (int)bootTimeline.durationMs(BS_SENSOR); })
+        .label("First reading")
+        .unit("ms")
+        .precision(0)
+        .order(2);
+
+    bootCard.value("Bt_Network", []()
+                   { return (int)bootTimeline.doneAtMs(BS_NETWORK); })
+        .label("Boot complete")
+        .unit("ms")
+        .precision(0)
+        .order(3);
+
+    bootCard.value("Bt_Stages", []()
+                   { return String(bootSummary); })
+        .label("Stages (ms)")
+        .order(4);
+}
 
-        if (boilerSettings.enabled->get() || forceON)
+static void syncBoilerConfig()
+{
+    BoilerConfig &cfg = boiler.config();
+    cfg.enabled = boilerSettings.enabled->get();
+    cfg.onThreshold = boilerSettings.onThreshold->get();
+    cfg.offThreshold = boilerSettings.offThreshold->get();
+    cfg.boilerTimeMin = boilerSettings.boilerTimeMin->get();
+    cfg.stopTimerOnTarget = boilerSettings.stopTimerOnTarget->get();
+    cfg.onlyOncePerPeriod = boilerSettings.onlyOncePerPeriod->get();
+    cfg.earlyStop = boilerSettings.earlyStop->get();
+    cfg.minOnSec = boilerSettings.minOnSec->get();
+    cfg.minOffSec = boilerSettings.minOffSec->get();
+    cfg.maxStartsPerHour = boilerSettings.maxStartsPerHour->get();
+}
+
+// Pre-heat for planned showers: once per minute look up the next target in the compiled table.
+static void applySchedule()
+{
+    if (!scheduleSettings.enabled->get())
+    {
+        return;
+    }
+    const time_t epoch = time(nullptr);
+    if (epoch < 24 * 60 * 60)
+    {
+        return; // NTP not synced yet
+    }
+    const uint32_t minuteNow = static_cast<uint32_t>(epoch / 60);
+    if (minuteNow == scheduleCheckedMinute)
+    {
+        return;
+    }
+    scheduleCheckedMinute = minuteNow;
+    checkPreheatOutcome(minuteNow);
+
+    const String plan = scheduleSettings.plan->get();
+    if (plan != compiledPlan)
+    {
+        compiledPlan = plan;
+        if (heatSchedule.compile(plan.c_str()))
         {
-            if (boilerTimeRemaining > 0)
-            {
-                if (!getBoilerState())
-                {
-                    setBoilerState(true); // Turn on the boiler
-                }
-                boilerTimeRemaining--; // count down in seconds
-            }
-            else
-            {
-                if (getBoilerState())
-                {
-                    setBoilerState(false); // Turn off the boiler
-                }
-            }
+            lmg.log(LL::Info, "Schedule compiled: %u showers per week", heatSchedule.count());
         }
         else
         {
-            if (getBoilerState())
-            {
-                setBoilerState(false); // Turn off the boiler if disabled
-            }
+            lmg.log(LL::Error, "Schedule syntax error at position %d: %s", heatSchedule.errorOffset(), plan.c_str());
         }
+    }
 
-        // Detect timer end transition to 0 -> clear WillShower and publish retained OFF
-        if (prevTime > 0 && boilerTimeRemaining <= 0)
-        {
-            if (willShowerRequested)
-            {
-                willShowerRequested = false;
-                if (mqtt.isConnected() && !topicWillShower.isEmpty())
-                {
-                    mqtt.publish(topicWillShower.c_str(), "0", true);
-                }
-            }
-            if (getBoilerState())
-            {
-                setBoilerState(false);
-            }
-        }
+    struct tm local;
+    localtime_r(&epoch, &local);
+    const HeatSchedule::Next next = heatSchedule.next(HeatSchedule::minuteOfWeek(local.tm_wday, local.tm_hour, local.tm_min));
+    const uint32_t targetMinute = minuteNow + next.minutesUntil;
+    const float maxLead = static_cast<float>(max(0, scheduleSettings.leadMin->get()));
+    const float estimate = scheduleSettings.adaptive->get() ? preheatModel.estimateMinutes(boiler.temperature()) : -1.0f;
+    const float lead = estimate >= 0.0f ? min(maxLead, estimate + PREHEAT_MARGIN_MIN) : maxLead;
+    if (next.index == HeatSchedule::NONE || next.minutesUntil > lead || targetMinute == scheduleFiredMinute)
+    {
+        return;
+    }
+    scheduleFiredMinute = targetMinute; // once per planned shower, even if the user cancels
+    preheatEstimateMin = estimate;
+    preheatPending = boiler.temperature() < boilerSettings.offThreshold->get();
+
+    const int minutes = next.minutesUntil + max(1, scheduleSettings.holdMin->get());
+    if (boiler.timeRemaining() >= minutes * 60)
+    {
+        return; // already heating long enough
+    }
+    boiler.startShowerTimer(minutes);
+    lmg.log(LL::Info, "Schedule: shower planned in %u min -> heating for %d min (estimated heat-up %.0f min)",
+            next.minutesUntil, minutes, estimate);
+    ShowDisplay();
+    if (mqtt.isConnected() && mqttTopics.ready())
+    {
+        mqtt.publish(mqttTopics.get(MT::WillShower), "1", true);
     }
 }
 
-static void cb_readTempSensor()
+// Realised pre-heat error: minutes between the planned shower and the tank reaching offThreshold.
+static void checkPreheatOutcome(uint32_t minuteNow)
 {
-    lmg.scopedTag("TEMP");
-    if (!ds18)
+    if (!preheatPending)
     {
-        lmg.log(LL::Error, "DS18B20 sensor not initialized");
         return;
     }
-    ds18->requestTemperatures();
-    float t = ds18->getTempCByIndex(0);
-    lmg.log(LL::Debug, "Raw sensor reading: %.2f°C", t);
+    const int error = static_cast<int>(minuteNow - scheduleFiredMinute);
+    if (boiler.temperature() >= boilerSettings.offThreshold->get())
+    {
+        preheatPending = false;
+        preheatErrorMin = error;
+        preheatErrorKnown = true;
+        lmg.log(LL::Info, "Pre-heat reached target %d min %s the planned time (estimated heat-up %.0f min)",
+                abs(error), error > 0 ? "after" : "before", preheatEstimateMin);
+    }
+    else if (error > max(1, scheduleSettings.holdMin->get()))
+    {
+        preheatPending = false; // cancelled or the timer ran out before the target
+    }
+}
+
+void UpdateBoilerAlarmState()
+{
+    lmg.scopedTag("UpdateBoilerAlarmState");
+    syncBoilerConfig();
+    boiler.updateAlarm();
+}
+
+void handeleBoilerState(bool forceON)
+{
+    lmg.scopedTag("handeleBoilerState");
+    syncBoilerConfig();
+    applySchedule();
+    boiler.tick(forceON);
+}
+
+static void applyTempReading(float t)
+{
+    lmg.scopedTag("TEMP");
+    lmg.log(LL::Debug, "Raw sensor reading: %.2f°C (conv %lums, busy %luus)",
+            t, (unsigned long)tempReader.lastConversionMs(), (unsigned long)tempReader.lastBusyUs());
 
     // Check for sensor fault (-127°C indicates sensor error)
     bool sensorError = (t <= -127.0f || t >= 85.0f); // DS18B20 valid range is -55°C to +125°C, but -127°C is error code
@@ -524,12 +1637,15 @@ static void cb_readTempSensor()
         if (!sensorFaultState)
         {
             sensorFaultState = true;
+            tempFilter.reset(); // do not blend pre-fault samples into the recovered series
             lmg.log(LL::Error, "SENSOR FAULT detected! Reading: %.2f°C", t);
         }
         lmg.log(LL::Error, "Invalid temperature reading: %.2f°C (sensor fault)", t);
-        // Try to check if sensor is still present
-        uint8_t deviceCount = ds18->getDeviceCount();
-        lmg.log(LL::Debug, "Devices still found: %d", deviceCount);
+        sensorTempsC[0] = NAN;
+        rawTempC = NAN;
+        // The reader searches the bus again after repeated faults
+        lmg.log(LL::Debug, "Probes known: %u (bus searches so far: %lu)",
+                (unsigned)tempReader.sensorCount(), (unsigned long)tempReader.rescanCount());
     }
     else
     {
@@ -540,8 +1656,16 @@ static void cb_readTempSensor()
             lmg.log(LL::Debug, "Sensor fault cleared! Reading: %.2f°C", t);
         }
 
-        temperature = t + tempSensorSettings.corrOffset->get();
-        lmg.log(LL::Trace, "Temperature updated: %.2f°C (offset: %.2f°C)", temperature, tempSensorSettings.corrOffset->get());
+        TempFilter::Config filterConfig;
+        filterConfig.medianN = static_cast<uint8_t>(constrain(tempSensorSettings.filterMedian->get(), 1, (int)TempFilter::MAX_MEDIAN));
+        filterConfig.emaAlpha = tempSensorSettings.filterAlpha->get();
+        filterConfig.maxRatePerMin = tempSensorSettings.filterMaxRate->get();
+        tempFilter.configure(filterConfig);
+
+        rawTempC = t + tempSensorSettings.corrOffset->get();
+        boiler.setTemperature(tempFilter.apply(rawTempC, millis()));
+        sensorTempsC[0] = boiler.temperature();
+        lmg.log(LL::Trace, "Temperature updated: %.2f°C (raw %.2f°C, offset: %.2f°C)", boiler.temperature(), rawTempC, tempSensorSettings.corrOffset->get());
     }
 }
 
@@ -558,10 +1682,6 @@ static void setupTempSensor()
     ds18 = new DallasTemperature(oneWireBus);
     ds18->begin();
 
-    // Configure for better compatibility
-    ds18->setWaitForConversion(true);  // Wait for conversion to complete
-    ds18->setCheckForConversion(true); // Check if conversion is done
-
     // Extended diagnostics
     uint8_t deviceCount = ds18->getDeviceCount();
     lmg.log(LL::Debug, "OneWire devices found: %d", deviceCount);
@@ -587,19 +1707,79 @@ static void setupTempSensor()
         // Check if sensor is using parasitic power
         bool parasitic = ds18->readPowerSupply(0);
         lmg.log(LL::Info, "Power mode: %s", parasitic ? "Normal (VCC connected)" : "Parasitic [4,7KΩ] (VCC=GND)");
+    }
 
-        // Set resolution to 12-bit for better accuracy
-        ds18->setResolution(12);
-        lmg.log(LL::Info, "Resolution set to 12-bit");
+    // Conversions are requested here and collected later from loop(), so the bus never blocks the CPU.
+    // begin() also writes the configured resolution to every probe.
+    // The boot sample runs single-shot at up to BOOT_SENSOR_BITS; readFirstTemperature() then
+    // switches to the configured mode.
+    const uint8_t bits = SensorModeStats::normalizeBits(tempSensorSettings.resolution->get());
+    const uint8_t oversample = SensorModeStats::normalizeOversample(tempSensorSettings.oversample->get());
+    tempReader.begin(ds18, min(bits, BOOT_SENSOR_BITS), 1);
+    sensorModes.select(bits, oversample);
+    lmg.log(LL::Info, "Read mode: %u-bit x%u", (unsigned)bits, (unsigned)oversample);
+    for (uint8_t i = 0; i < tempReader.sensorCount(); ++i)
+    {
+        const uint8_t *a = tempReader.address(i);
+        lmg.log(LL::Info, "Sensor %u ROM %02X%02X%02X%02X%02X%02X%02X%02X, offset %.2f°C", (unsigned)(i + 1),
+                a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], tempSensorSettings.offsetFor(i));
+    }
+    if (deviceCount > TempSensorReader::MAX_SENSORS)
+    {
+        lmg.log(LL::Warn, "%d devices on the bus, only the first %u are read", deviceCount, (unsigned)TempSensorReader::MAX_SENSORS);
     }
 
     tempSensorSettings.readInterval->setCallback([](int)
                                                  { applyTempReadInterval(); });
     applyTempReadInterval();
+    tempSensorSettings.resolution->setCallback([](int)
+                                               { applyTempSensorMode(); });
+    tempSensorSettings.oversample->setCallback([](int)
+                                               { applyTempSensorMode(); });
         lmg.log(LL::Debug, "DS18B20 initialized on GPIO %d, offset %.2f°C",
             pin, tempSensorSettings.corrOffset->get());
 }
 
+// Sensors 2..n are shown only; sensor 1 goes through applyTempReading().
+static void applyExtraSensorReadings()
+{
+    for (uint8_t i = 1; i < tempReader.sensorCount(); ++i)
+    {
+        const float raw = tempReader.lastRawC(i);
+        sensorTempsC[i] = (raw <= -127.0f || raw >= 85.0f) ? NAN : raw + tempSensorSettings.offsetFor(i);
+    }
+}
+
+// Boot-time conversion, collected inline so the first control decision uses a real reading.
+// setupTempSensor() started the reader in a fast single-shot mode; the configured mode
+// applies from the next sample on.
+static void readFirstTemperature()
+{
+    if (tempReader.sensorCount() == 0 && tempReader.rescan(millis()) == 0)
+    {
+        applyTempSensorMode(); // fault already flagged; the reader keeps searching the bus
+        return;
+    }
+    const uint32_t startMs = millis();
+    while (!tempReader.update(millis()))
+    {
+        const uint32_t now = millis();
+        if (now - startMs >= BOOT_SENSOR_TIMEOUT_MS)
+        {
+            lmg.log(LL::Warn, "No first reading after %lu ms -> sensor task retries", (unsigned long)(now - startMs));
+            applyTempSensorMode();
+            return;
+        }
+        const uint32_t next = tempReader.nextActionMs(now);
+        delay(next > now ? min<uint32_t>(next - now, 10) : 1);
+    }
+    applyExtraSensorReadings();
+    applyTempReading(tempReader.lastRawC(0));
+    lmg.log(LL::Info, "First reading %.2f°C in %lu ms (%u-bit)", boiler.temperature(),
+            (unsigned long)(millis() - startMs), (unsigned)tempReader.resolutionBits());
+    applyTempSensorMode();
+}
+
 static void applyTempReadInterval()
 {
     float intervalSec = (float)tempSensorSettings.readInterval->get();
@@ -608,11 +1788,37 @@ static void applyTempReadInterval()
         intervalSec = 10.0f;
     }
 
-    TempReadTicker.detach();
-    TempReadTicker.attach(intervalSec, cb_readTempSensor);
+    tempReader.setIntervalMs(static_cast<uint32_t>(intervalSec * 1000.0f));
     lmg.log(LL::Debug, "Temp read interval set: %.1fs", intervalSec);
 }
 
+// "x1 94 ms ±0.145 | x4 380 ms ±0.074" for every measured oversampling factor, "-" if none.
+static String describeSensorModes(uint8_t bits)
+{
+    char buf[96];
+    size_t len = 0;
+    buf[0] = '\0';
+    for (uint8_t os = 1; os <= SensorModeStats::MAX_OVERSAMPLE; os *= 2)
+    {
+        const SensorModeStats::Entry &e = sensorModes.stats(bits, os);
+        if (e.samples == 0 || len >= sizeof(buf))
+        {
+            continue;
+        }
+        len += snprintf(buf + len, sizeof(buf) - len, "%sx%u %u ms ±%.3f", len ? " | " : "",
+                        (unsigned)os, (unsigned)(e.sampleMs + 0.5f), e.noiseC);
+    }
+    return String(len ? buf : "-");
+}
+
+static void applyTempSensorMode()
+{
+    const uint8_t bits = SensorModeStats::normalizeBits(tempSensorSettings.resolution->get());
+    const uint8_t oversample = SensorModeStats::normalizeOversample(tempSensorSettings.oversample->get());
+    tempReader.setMode(bits, oversample); // applied at the start of the next sample
+    lmg.log(LL::Info, "Temp read mode set: %u-bit x%u", (unsigned)bits, (unsigned)oversample);
+}
+
 //----------------------------------------
 // LOGGING / IO / MQTT HELPERS
 //----------------------------------------
@@ -668,6 +1874,7 @@ static void registerIOBindings()
                 lmg.logTag(LL::Trace,"IO", "Reset button pressed at startup -> restoring defaults");
                 ConfigManager.clearAllFromPrefs();
                 ConfigManager.saveAll();
+                markSettingsStored();
                 delay(3000);
                 ESP.restart(); },
         },
@@ -693,20 +1900,7 @@ static void registerIOBindings()
         IO_SHOWER_ID,
         cm::IOManager::DigitalInputEventCallbacks{
             .onPress = []()
-            {
-                if (!displayActive)
-                {
-                    lmg.log(LL::Debug, "[MAIN] Shower button pressed while display OFF -> wake display only");
-                    ShowDisplay();
-                    return;
-                }
-
-                const bool newState = !willShowerRequested;
-                lmg.log(LL::Debug, "[MAIN] Shower button pressed -> toggling shower request to %s",
-                        newState ? "ON" : "OFF");
-                ShowDisplay();
-                handleShowerRequest(newState);
-            },
+            { postCommand(CommandType::ToggleShower, CommandSource::Button); },
         });
 }
 
@@ -749,28 +1943,20 @@ static void updateMqttTopics()
         base = String(APP_NAME); // Base-Fallback
     }
 
-    if (base != mqttBaseTopic)
+    if (mqttTopics.hasBase(base.c_str()))
     {
-        mqttBaseTopic = base;
-        didStartupMQTTPropagate = false;
+        return; // unchanged, keep the table
     }
 
-    topicActualState = mqttBaseTopic + "/ActualState";
-    topicActualBoilerTemp = mqttBaseTopic + "/TemperatureBoiler";
-    topicActualTimeRemaining = mqttBaseTopic + "/TimeRemaining";
-    topicYouCanShowerNow = mqttBaseTopic + "/YouCanShowerNow";
-
-    const String sp = mqttBaseTopic + "/Settings";
-    topicSetShowerTime = sp + "/SetShowerTime";
-    topicWillShower = sp + "/WillShower";
-    topicSave = sp + "/Save";
-    topicBoilerEnabled = sp + "/BoilerEnabled";
-    topicOnThreshold = sp + "/OnThreshold";
-    topicOffThreshold = sp + "/OffThreshold";
-    topicBoilerTimeMin = sp + "/BoilerTimeMin";
-    topicStopTimerOnTarget = sp + "/StopTimerOnTarget";
-    topicOncePerPeriod = sp + "/OncePerPeriod";
-    topicYouCanShowerPeriodMin = sp + "/YouCanShowerPeriodMin";
+    didStartupMQTTPropagate = false;
+    const bool built = mqttTopics.build(base.c_str());
+    mqttDispatch.setBase(built ? mqttTopics.base() : nullptr);
+    if (!built)
+    {
+        lmg.log(LL::Error, "Base topic too long (max %u): %s", (unsigned)MqttTopicTable::MAX_BASE_LEN, base.c_str());
+        return;
+    }
+    lmg.log(LL::Debug, "Topic table built: %u bytes", (unsigned)mqttTopics.bytesUsed());
 }
 
 static void setupMqttCallbacks()
@@ -778,307 +1964,490 @@ static void setupMqttCallbacks()
     lmg.scopedTag("setupMqttCallbacks");
     boilerSettings.enabled->setCallback([](bool v)
                                         {
+        noteSettingChanged(PK_ENABLED);
         if (mqtt.isConnected()) {
-            mqtt.publish(topicBoilerEnabled.c_str(), v ? "1" : "0", true);
+            mqtt.publish(mqttTopics.get(MT::BoilerEnabled), v ? "1" : "0", true);
         } });
 
     boilerSettings.onThreshold->setCallback([](float v)
                                             {
+        noteSettingChanged(PK_ON_THRESHOLD);
         if (mqtt.isConnected()) {
-            mqtt.publish(topicOnThreshold.c_str(), String(v), true);
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%.2f", v);
+            mqtt.publish(mqttTopics.get(MT::OnThreshold), buf, true);
         } });
 
     boilerSettings.offThreshold->setCallback([](float v)
                                              {
+        noteSettingChanged(PK_OFF_THRESHOLD);
         if (mqtt.isConnected()) {
-            mqtt.publish(topicOffThreshold.c_str(), String(v), true);
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%.2f", v);
+            mqtt.publish(mqttTopics.get(MT::OffThreshold), buf, true);
         } });
 
     boilerSettings.boilerTimeMin->setCallback([](int v)
                                               {
+        noteSettingChanged(PK_BOILER_TIME);
         if (mqtt.isConnected()) {
-            mqtt.publish(topicBoilerTimeMin.c_str(), String(v), true);
-            mqtt.publish(topicYouCanShowerPeriodMin.c_str(), String(v), true);
+            char buf[12];
+            snprintf(buf, sizeof(buf), "%d", v);
+            mqtt.publish(mqttTopics.get(MT::BoilerTimeMin), buf, true);
+            mqtt.publish(mqttTopics.get(MT::YouCanShowerPeriodMin), buf, true);
         }
-        lastYouCanShower1PeriodId = -1;
-        lastPublishedYouCanShower = false; });
+        boiler.resetShowerNotice(); });
 
     boilerSettings.stopTimerOnTarget->setCallback([](bool v)
                                                   {
+        noteSettingChanged(PK_STOP_ON_TARGET);
         if (mqtt.isConnected()) {
-            mqtt.publish(topicStopTimerOnTarget.c_str(), v ? "1" : "0", true);
+            mqtt.publish(mqttTopics.get(MT::StopTimerOnTarget), v ? "1" : "0", true);
         } });
 
     boilerSettings.onlyOncePerPeriod->setCallback([](bool v)
                                                   {
+        noteSettingChanged(PK_ONCE_PER_PERIOD);
         if (mqtt.isConnected()) {
-            mqtt.publish(topicOncePerPeriod.c_str(), v ? "1" : "0", true);
+            mqtt.publish(mqttTopics.get(MT::OncePerPeriod), v ? "1" : "0", true);
         }
-        lastYouCanShower1PeriodId = -1;
-        lastPublishedYouCanShower = false; });
-}
-
-// Compute current period ID for once-per-period gating
-static long getCurrentPeriodId()
-{
-    const long periodMin = max(1, boilerSettings.boilerTimeMin->get());
-    const long periodSec = periodMin * 60L;
-    time_t now = time(nullptr);
-    if (now > 24 * 60 * 60)
-    {
-        return now / periodSec;
-    }
-    return (long)((millis() / 1000UL) / periodSec);
+        boiler.resetShowerNotice(); });
 }
 
+// Publish state topics whose value changed beyond their deadband (or went silent too long).
+// retained=true forces a full retained snapshot (first connect).
 static void publishMqttState(bool retained)
 {
     lmg.scopedTag("publishMqttState");
-    if (!mqtt.isConnected() || mqttBaseTopic.isEmpty())
+    if (!mqtt.isConnected() || !mqttTopics.ready())
     {
         return;
     }
 
-    mqtt.publish(topicActualBoilerTemp.c_str(), String(temperature), retained);
-
-    int total = max(0, boilerTimeRemaining);
-    int h = total / 3600;
-    int m = (total % 3600) / 60;
-    int s = total % 60;
-    char buf[12];
-    snprintf(buf, sizeof(buf), "%d:%02d:%02d", h, m, s);
-    mqtt.publish(topicActualTimeRemaining.c_str(), String(buf), retained);
+    syncBoilerConfig();
+    publishCache.setDeadband(PUB_TEMPERATURE, publishSettings.tempDeadband->get());
+    publishCache.setDeadband(PUB_TEMPERATURE_RAW, publishSettings.tempDeadband->get());
+    publishCache.setDeadband(PUB_TIME_REMAINING, static_cast<float>(publishSettings.timeStepSec->get()));
+    publishCache.setDeadband(PUB_TIME_TO_TARGET, static_cast<float>(publishSettings.timeStepSec->get()));
+    publishCache.setMaxSilence(static_cast<uint32_t>(max(0, publishSettings.maxSilenceSec->get())) * 1000UL);
+    if (retained)
+    {
+        publishCache.invalidate();
+    }
 
-    mqtt.publish(topicActualState.c_str(), getBoilerState() ? "1" : "0", retained);
+    const uint32_t now = millis();
+    char buf[16];
+    bool changed = false;
 
-    const bool canShower = (temperature >= boilerSettings.offThreshold->get()) && getBoilerState();
-    youCanShowerNow = canShower;
-    if (!boilerSettings.onlyOncePerPeriod->get())
+    const float temperature = boiler.temperature();
+    if (publishCache.offer(PUB_TEMPERATURE, temperature, now))
     {
-        mqtt.publish(topicYouCanShowerNow.c_str(), canShower ? "1" : "0", retained);
-        lastPublishedYouCanShower = canShower;
+        changed = true;
+        snprintf(buf, sizeof(buf), "%.2f", temperature);
+        mqtt.publish(mqttTopics.get(MT::TemperatureBoiler), buf, retained);
     }
-    else
+
+    if (!isnan(rawTempC) && publishCache.offer(PUB_TEMPERATURE_RAW, rawTempC, now))
     {
-        const long pid = getCurrentPeriodId();
-        if (canShower)
-        {
-            if (pid != lastYouCanShower1PeriodId)
-            {
-                mqtt.publish(topicYouCanShowerNow.c_str(), "1", true);
-                lastYouCanShower1PeriodId = pid;
-                lastPublishedYouCanShower = true;
-            }
-        }
-        else
-        {
-            if (lastPublishedYouCanShower)
-            {
-                mqtt.publish(topicYouCanShowerNow.c_str(), "0", true);
-                lastPublishedYouCanShower = false;
-            }
-        }
+        changed = true;
+        snprintf(buf, sizeof(buf), "%.2f", rawTempC);
+        mqtt.publish(mqttTopics.get(MT::TemperatureBoilerRaw), buf, retained);
     }
 
-}
-
-static void publishMqttStateIfNeeded()
-{
-    lmg.scopedTag("publishMqttStateIfNeeded");
-    const float intervalSec = mqtt.settings().publishIntervalSec.get();
-    if (intervalSec <= 0.0f)
+    const int total = max(0, boiler.timeRemaining());
+    if (publishCache.offer(PUB_TIME_REMAINING, static_cast<float>(total), now))
     {
-        return;
+        changed = true;
+        int h = total / 3600;
+        int m = (total % 3600) / 60;
+        int s = total % 60;
+        snprintf(buf, sizeof(buf), "%d:%02d:%02d", h, m, s);
+        mqtt.publish(mqttTopics.get(MT::TimeRemaining), buf, retained);
     }
 
-    const unsigned long intervalMs = static_cast<unsigned long>(intervalSec * 1000.0f);
-    if (intervalMs == 0)
+    const int32_t eta = tankModel.secondsToTarget(temperature, boiler.config().offThreshold);
+    if (publishCache.offer(PUB_TIME_TO_TARGET, static_cast<float>(eta), now))
     {
-        return;
+        changed = true;
+        snprintf(buf, sizeof(buf), "%ld", (long)eta);
+        mqtt.publish(mqttTopics.get(MT::TimeToTarget), buf, retained);
+    }
+
+    const bool relayOn = getBoilerState();
+    if (publishCache.offer(PUB_ACTUAL_STATE, relayOn ? 1.0f : 0.0f, now))
+    {
+        changed = true;
+        mqtt.publish(mqttTopics.get(MT::ActualState), relayOn ? "1" : "0", retained);
+    }
+
+    youCanShowerNow = boiler.canShowerNow();
+    const BoilerController::ShowerNotice notice = boiler.evaluateShowerNotice(retained);
+    if (notice.publish)
+    {
+        // once-per-period mode already publishes edges only; plain mode goes through the cache
+        const float value = notice.value ? 1.0f : 0.0f;
+        const bool send = boiler.config().onlyOncePerPeriod || publishCache.offer(PUB_CAN_SHOWER, value, now);
+        if (send)
+        {
+            changed = true;
+            publishCache.markPublished(PUB_CAN_SHOWER, value, now);
+            mqtt.publish(mqttTopics.get(MT::YouCanShowerNow), notice.value ? "1" : "0", notice.retained);
+        }
     }
 
-    const unsigned long now = millis();
-    if (lastMqttPublishMs == 0 || (now - lastMqttPublishMs >= intervalMs))
+    if (changed && publishSettings.jsonState->get())
     {
-        lastMqttPublishMs = now;
-        publishMqttState(false);
+        publishJsonState(retained);
     }
 }
 
-static void handleMqttMessage(const char *topic, const uint8_t *payload, unsigned int length)
+static void formatNextShower(char *out, size_t size)
 {
-    lmg.scopedTag("MQTT");
-    if (!topic || !payload || length == 0)
+    static const char *const DAYS[7] = {"Mo", "Tu", "We", "Th", "Fr", "Sa", "Su"};
+    const time_t epoch = time(nullptr);
+    if (!scheduleSettings.enabled->get() || heatSchedule.count() == 0 || epoch < 24 * 60 * 60)
     {
-        lmg.log(LL::Warn, "Callback with invalid payload - ignored");
+        snprintf(out, size, "-");
         return;
     }
+    struct tm local;
+    localtime_r(&epoch, &local);
+    const HeatSchedule::Next next = heatSchedule.next(HeatSchedule::minuteOfWeek(local.tm_wday, local.tm_hour, local.tm_min));
+    const uint16_t minuteOfDay = next.minuteOfWeek % HeatSchedule::MINUTES_PER_DAY;
+    snprintf(out, size, "%s %02u:%02u (in %u:%02u)", DAYS[next.minuteOfWeek / HeatSchedule::MINUTES_PER_DAY],
+             minuteOfDay / 60, minuteOfDay % 60, next.minutesUntil / 60, next.minutesUntil % 60);
+}
 
-    String messageTemp(reinterpret_cast<const char *>(payload), length);
-    messageTemp.trim();
-
-    lmg.log(LL::Debug, "Topic[%s] <-- [%s]", topic, messageTemp.c_str());
-
-    if (strcmp(topic, topicSetShowerTime.c_str()) == 0)
+// Put one runtime field into doc under its key; values are the integer codes from
+// readRuntimeFields(), strings come from the preformatted snapshots.
+static void putRuntimeField(JsonDocument &doc, uint8_t field, const int32_t *v)
+{
+    switch (field)
     {
-        if (messageTemp.equalsIgnoreCase("null") ||
-            messageTemp.equalsIgnoreCase("undefined") ||
-            messageTemp.equalsIgnoreCase("NaN") ||
-            messageTemp.equalsIgnoreCase("Infinity") ||
-            messageTemp.equalsIgnoreCase("-Infinity"))
+    case RF_ENABLED:
+        doc["enabled"] = v[field] != 0;
+        break;
+    case RF_RELAY:
+        doc["relay"] = v[field] != 0;
+        break;
+    case RF_CAN_SHOWER:
+        doc["canShower"] = v[field] != 0;
+        break;
+    case RF_WILL_SHOWER:
+        doc["willShower"] = v[field] != 0;
+        break;
+    case RF_SENSOR_FAULT:
+        doc["sensorFault"] = v[field] != 0;
+        break;
+    case RF_TEMP:
+        doc["temp"] = v[field] / 100.0f;
+        break;
+    case RF_TEMP_RAW:
+        if (v[field] == INT32_MIN)
         {
-            lmg.log(LL::Warn, "Received invalid value from MQTT: %s", messageTemp.c_str());
-            messageTemp = "0";
+            doc["tempRaw"] = nullptr;
         }
-        const int mins = messageTemp.toInt();
-        if (mins > 0)
+        else
         {
-            boilerTimeRemaining = mins * 60;
-            willShowerRequested = true;
-            if (!getBoilerState())
-            {
-                setBoilerState(true);
-            }
-            ShowDisplay();
-            lmg.log(LL::Debug, "MQTT set shower time: %d min (relay ON)", mins);
-            if (mqtt.isConnected())
-            {
-                mqtt.publish(topicWillShower.c_str(), "1", true);
-            }
+            doc["tempRaw"] = v[field] / 100.0f;
         }
-        return;
+        break;
+    case RF_TIME_LEFT:
+    {
+        char buf[16];
+        timeLeftText.read(buf, sizeof(buf));
+        doc["timeLeft"] = v[field];
+        doc["timeLeftFmt"] = buf;
+        break;
+    }
+    case RF_SET_MIN:
+        doc["setMin"] = v[field];
+        break;
+    case RF_ETA:
+        doc["etaSec"] = v[field];
+        break;
+    case RF_NEXT_SHOWER:
+    {
+        char buf[32];
+        nextShowerText.read(buf, sizeof(buf));
+        doc["nextShower"] = buf;
+        break;
+    }
     }
+}
+
+static void readRuntimeFields(int32_t *v)
+{
+    const float temperature = boiler.temperature();
+    v[RF_ENABLED] = boilerSettings.enabled->get() ? 1 : 0;
+    v[RF_RELAY] = getBoilerState() ? 1 : 0;
+    v[RF_CAN_SHOWER] = boiler.canShowerNow() ? 1 : 0;
+    v[RF_WILL_SHOWER] = boiler.willShowerRequested() ? 1 : 0;
+    v[RF_SENSOR_FAULT] = sensorFaultState ? 1 : 0;
+    v[RF_TEMP] = static_cast<int32_t>(lroundf(temperature * 100.0f));
+    v[RF_TEMP_RAW] = isnan(rawTempC) ? INT32_MIN : static_cast<int32_t>(lroundf(rawTempC * 100.0f));
+    v[RF_TIME_LEFT] = max(0, boiler.timeRemaining());
+    v[RF_SET_MIN] = boilerSettings.boilerTimeMin->get();
+    v[RF_ETA] = tankModel.secondsToTarget(temperature, boilerSettings.offThreshold->get());
+    v[RF_NEXT_SHOWER] = static_cast<int32_t>(time(nullptr) / 60); // text changes with the clock
+}
 
-    if (strcmp(topic, topicWillShower.c_str()) == 0)
+// Serialize all fields (mask = all) or a delta into out; returns 0 when it did not fit.
+static size_t writeRuntimeJson(char *out, size_t size, uint32_t mask, uint32_t seq)
+{
+    static JsonDocument doc;
+    doc.clear();
+    doc["seq"] = seq;
+    for (uint8_t f = 0; f < RF_COUNT; ++f)
     {
-        const bool willShower = messageTemp.equalsIgnoreCase("1") ||
-                                messageTemp.equalsIgnoreCase("true") ||
-                                messageTemp.equalsIgnoreCase("on");
-        if (willShower == willShowerRequested)
+        if (mask & (1u << f))
         {
-            return;
+            putRuntimeField(doc, f, runtimeValues);
         }
-        if (willShower)
+    }
+    const size_t len = serializeJson(doc, out, size);
+    return (len == 0 || len >= size - 1) ? 0 : len;
+}
+
+// Snapshot stage: rebuild the runtime JSON and the preformatted card strings only when a field
+// changed, so the web side never evaluates or serializes anything per request. Changed fields
+// are pushed to SSE clients as one rate-limited delta, serialized once for all of them.
+static void updateRuntimeSnapshot()
+{
+    const uint32_t now = millis();
+    int32_t v[RF_COUNT];
+    readRuntimeFields(v);
+    const uint32_t changed = runtimeDelta.update(v);
+    if (changed)
+    {
+        if (changed & (1u << RF_TIME_LEFT))
         {
-            int mins = boilerSettings.boilerTimeMin->get();
-            if (mins <= 0)
-                mins = 60;
-            if (boilerTimeRemaining <= 0)
-            {
-                boilerTimeRemaining = mins * 60;
-            }
-            willShowerRequested = true;
-            if (!getBoilerState())
-            {
-                setBoilerState(true);
-            }
-            ShowDisplay();
-            lmg.log(LL::Debug, "HA request: will shower -> set %d min (relay ON)", mins);
+            char timeLeft[16];
+            snprintf(timeLeft, sizeof(timeLeft), "%d:%02d:%02d", (int)(v[RF_TIME_LEFT] / 3600),
+                     (int)((v[RF_TIME_LEFT] % 3600) / 60), (int)(v[RF_TIME_LEFT] % 60));
+            timeLeftText.set(timeLeft);
+        }
+        if (changed & (1u << RF_NEXT_SHOWER))
+        {
+            char nextShower[32];
+            formatNextShower(nextShower, sizeof(nextShower));
+            nextShowerText.set(nextShower);
+        }
+        memcpy(runtimeValues, v, sizeof(runtimeValues));
+
+        char *out = runtimeJson.beginWrite();
+        const size_t len = writeRuntimeJson(out, decltype(runtimeJson)::CAPACITY, RUNTIME_ALL_FIELDS, runtimeSnapshotBuilds + 1);
+        if (len == 0)
+        {
+            runtimeJson.cancelWrite();
+            lmg.log(LL::Warn, "Runtime JSON truncated");
         }
         else
         {
-            willShowerRequested = false;
-            boilerTimeRemaining = 0;
-            if (getBoilerState())
-            {
-                setBoilerState(false);
-            }
-            lmg.log(LL::Debug, "HA request: will shower = false -> timer cleared, relay OFF");
+            runtimeJson.commit(len);
+            runtimeSnapshotBuilds++;
         }
-        return;
     }
 
-    if (strcmp(topic, topicBoilerEnabled.c_str()) == 0)
+    const uint32_t mask = runtimeDelta.takeDue(now);
+    if (mask == 0 || runtimeEvents.count() == 0)
+    {
+        return; // new clients get the full snapshot on connect, so nothing is lost
+    }
+    static char delta[256];
+    const size_t len = writeRuntimeJson(delta, sizeof(delta), mask, runtimeSnapshotBuilds);
+    if (len == 0)
     {
-        const bool v = messageTemp.equalsIgnoreCase("1") ||
-                       messageTemp.equalsIgnoreCase("true") ||
-                       messageTemp.equalsIgnoreCase("on");
-        boilerSettings.enabled->set(v);
-        lmg.log(LL::Debug, "BoilerEnabled set to %s", v ? "true" : "false");
         return;
     }
+    runtimeEvents.send(delta, "delta", runtimeSnapshotBuilds); // one buffer, queued to every client
+    runtimeEventsSent++;
+}
 
-    if (strcmp(topic, topicOnThreshold.c_str()) == 0)
+// One JSON message with all state fields (<base>/State). The document and output buffer are
+// reused; members are overwritten in place, so only the first call allocates the pool.
+static void publishJsonState(bool retained)
+{
+    static JsonDocument doc;
+    static char out[192];
+
+    const time_t epoch = time(nullptr);
+    doc["seq"] = ++stateSeq;
+    doc["ts"] = epoch > 24 * 60 * 60 ? static_cast<uint32_t>(epoch) : 0; // 0 until NTP synced
+    doc["up"] = millis() / 1000UL;
+    doc["temp"] = roundf(boiler.temperature() * 100.0f) / 100.0f;
+    if (isnan(rawTempC))
     {
-        const float v = messageTemp.toFloat();
-        if (v > 0)
-        {
-            boilerSettings.onThreshold->set(v);
-            lmg.log(LL::Debug, "OnThreshold set to %.1f", v);
-        }
+        doc["tempRaw"] = nullptr; // sensor fault: no plausible-looking 0 °C
+    }
+    else
+    {
+        doc["tempRaw"] = roundf(rawTempC * 100.0f) / 100.0f;
+    }
+    doc["remaining"] = max(0, boiler.timeRemaining());
+    doc["eta"] = tankModel.secondsToTarget(boiler.temperature(), boiler.config().offThreshold);
+    doc["relay"] = getBoilerState() ? 1 : 0;
+    doc["canShower"] = youCanShowerNow ? 1 : 0;
+    doc["willShower"] = boiler.willShowerRequested() ? 1 : 0;
+
+    const size_t len = serializeJson(doc, out, sizeof(out));
+    if (len == 0 || len >= sizeof(out) - 1)
+    {
+        lmg.log(LL::Warn, "State JSON truncated (%u bytes)", (unsigned)len);
         return;
     }
+    mqtt.publish(mqttTopics.get(MT::State), out, retained);
+}
 
-    if (strcmp(topic, topicOffThreshold.c_str()) == 0)
+// Coalesce state changes from the current pass into one publish shortly after.
+static void requestStatePublish()
+{
+    if (publishPending)
     {
-        const float v = messageTemp.toFloat();
-        if (v > 0)
-        {
-            boilerSettings.offThreshold->set(v);
-            lmg.log(LL::Debug, "OffThreshold set to %.1f", v);
-        }
         return;
     }
+    publishPending = true;
+    loopScheduler.scheduleAt(loopTasks.publish, millis() + PUBLISH_COALESCE_MS);
+}
 
-    if (strcmp(topic, topicBoilerTimeMin.c_str()) == 0)
+// Change-driven state publish. Runs on publishIntervalSec (heartbeat check) and after
+// requestStatePublish(); the cache suppresses unchanged values.
+static void publishMqttStateIfNeeded()
+{
+    lmg.scopedTag("publishMqttStateIfNeeded");
+    publishPending = false;
+    const float intervalSec = mqtt.settings().publishIntervalSec.get();
+    const uint32_t intervalMs = intervalSec > 0.0f ? static_cast<uint32_t>(intervalSec * 1000.0f) : 0;
+    if (intervalMs == 0)
     {
-        const int v = messageTemp.toInt();
-        if (v >= 0)
-        {
-            boilerSettings.boilerTimeMin->set(v);
-            lmg.log(LL::Debug, "BoilerTimeMin set to %d", v);
-            lastYouCanShower1PeriodId = -1;
-            lastPublishedYouCanShower = false;
-        }
+        loopScheduler.setInterval(loopTasks.publish, 1000); // disabled: only watch the setting
         return;
     }
 
-    if (strcmp(topic, topicStopTimerOnTarget.c_str()) == 0)
+    loopScheduler.setInterval(loopTasks.publish, intervalMs);
+    HeapProbe::begin();
+    publishMqttState(false);
+    HeapProbe::end();
+}
+
+// Inbound handlers, one per topic (payload already parsed by mqttDispatch). They only validate
+// and enqueue; applyCommand() does the work.
+static void onMqttSetShowerTime(const MqttValue &v)
+{
+    if (!v.valid)
     {
-        const bool v = messageTemp.equalsIgnoreCase("1") ||
-                       messageTemp.equalsIgnoreCase("true") ||
-                       messageTemp.equalsIgnoreCase("on");
-        boilerSettings.stopTimerOnTarget->set(v);
-        lmg.log(LL::Debug, "StopTimerOnTarget set to %s", v ? "true" : "false");
+        lmg.log(LL::Warn, "Received invalid value from MQTT: %.*s", (int)v.rawLen, v.raw);
         return;
     }
+    if (v.i > 0)
+    {
+        postCommand(CommandType::SetShowerTime, CommandSource::Mqtt, false, static_cast<int32_t>(v.i));
+    }
+}
+
+static void onMqttWillShower(const MqttValue &v)
+{
+    postCommand(CommandType::WillShower, CommandSource::Mqtt, v.b);
+}
+
+static void onMqttBoilerEnabled(const MqttValue &v)
+{
+    postCommand(CommandType::SetEnabled, CommandSource::Mqtt, v.b);
+}
 
-    if (strcmp(topic, topicOncePerPeriod.c_str()) == 0)
+static void onMqttOnThreshold(const MqttValue &v)
+{
+    if (v.valid && v.f > 0)
     {
-        const bool v = messageTemp.equalsIgnoreCase("1") ||
-                       messageTemp.equalsIgnoreCase("true") ||
-                       messageTemp.equalsIgnoreCase("on");
-        boilerSettings.onlyOncePerPeriod->set(v);
-        lmg.log(LL::Debug, "OncePerPeriod set to %s", v ? "true" : "false");
-        lastYouCanShower1PeriodId = -1;
-        lastPublishedYouCanShower = false;
-        return;
+        postCommand(CommandType::SetOnThreshold, CommandSource::Mqtt, false, 0, v.f);
     }
+}
 
-    if (strcmp(topic, topicYouCanShowerPeriodMin.c_str()) == 0)
+static void onMqttOffThreshold(const MqttValue &v)
+{
+    if (v.valid && v.f > 0)
     {
-        int v = messageTemp.toInt();
-        if (v <= 0)
-            v = 45;
-        boilerSettings.boilerTimeMin->set(v);
-        lmg.log(LL::Debug, "YouCanShowerPeriodMin mapped to BoilerTimeMin = %d", v);
-        lastYouCanShower1PeriodId = -1;
-        lastPublishedYouCanShower = false;
-        return;
+        postCommand(CommandType::SetOffThreshold, CommandSource::Mqtt, false, 0, v.f);
     }
+}
 
-    if (strcmp(topic, topicSave.c_str()) == 0)
+static void onMqttBoilerTimeMin(const MqttValue &v)
+{
+    if (v.valid && v.i >= 0)
     {
-        ConfigManager.saveAll();
-        if (mqtt.isConnected())
+        postCommand(CommandType::SetShowerPeriod, CommandSource::Mqtt, false, static_cast<int32_t>(v.i));
+    }
+}
+
+static void onMqttStopTimerOnTarget(const MqttValue &v)
+{
+    postCommand(CommandType::SetStopOnTarget, CommandSource::Mqtt, v.b);
+}
+
+static void onMqttOncePerPeriod(const MqttValue &v)
+{
+    postCommand(CommandType::SetOncePerPeriod, CommandSource::Mqtt, v.b);
+}
+
+static void onMqttYouCanShowerPeriodMin(const MqttValue &v)
+{
+    const int32_t mins = (v.valid && v.i > 0) ? static_cast<int32_t>(v.i) : 45;
+    postCommand(CommandType::SetShowerPeriod, CommandSource::Mqtt, false, mins);
+}
+
+static void onMqttSave(const MqttValue &)
+{
+    postCommand(CommandType::Save, CommandSource::Mqtt);
+}
+
+static void setupMqttDispatch()
+{
+    struct Route
+    {
+        MqttTopic topic;
+        PayloadKind kind;
+        MqttHandler handler;
+    };
+    static const Route ROUTES[] = {
+        {MT::SetShowerTime, PayloadKind::Int, onMqttSetShowerTime},
+        {MT::WillShower, PayloadKind::Bool, onMqttWillShower},
+        {MT::BoilerEnabled, PayloadKind::Bool, onMqttBoilerEnabled},
+        {MT::OnThreshold, PayloadKind::Float, onMqttOnThreshold},
+        {MT::OffThreshold, PayloadKind::Float, onMqttOffThreshold},
+        {MT::BoilerTimeMin, PayloadKind::Int, onMqttBoilerTimeMin},
+        {MT::StopTimerOnTarget, PayloadKind::Bool, onMqttStopTimerOnTarget},
+        {MT::OncePerPeriod, PayloadKind::Bool, onMqttOncePerPeriod},
+        {MT::YouCanShowerPeriodMin, PayloadKind::Int, onMqttYouCanShowerPeriodMin},
+        {MT::Save, PayloadKind::None, onMqttSave},
+    };
+
+    mqttDispatch.clear();
+    for (const Route &r : ROUTES)
+    {
+        if (!mqttDispatch.add(MqttTopicTable::suffix(r.topic), r.kind, r.handler))
         {
-            mqtt.publish(topicSave.c_str(), "OK", false);
+            lmg.log(LL::Error, "MQTT route not added: %s", MqttTopicTable::suffix(r.topic));
         }
-        lmg.log(LL::Info, "[MAIN] Settings saved via MQTT");
+    }
+    mqttDispatch.setBase(mqttTopics.ready() ? mqttTopics.base() : nullptr);
+}
+
+static void handleMqttMessage(const char *topic, const uint8_t *payload, unsigned int length)
+{
+    lmg.scopedTag("MQTT");
+    if (!topic || !payload || length == 0)
+    {
+        lmg.log(LL::Warn, "Callback with invalid payload - ignored");
         return;
     }
 
-    lmg.log(LL::Warn, "Topic [%s] not recognized - ignored", topic);
+    lmg.log(LL::Debug, "Topic[%s] <-- [%.*s]", topic, (int)length, reinterpret_cast<const char *>(payload));
+    syncBoilerConfig();
+
+    if (!mqttDispatch.dispatch(topic, payload, length))
+    {
+        lmg.log(LL::Warn, "Topic [%s] not recognized - ignored", topic);
+    }
 }
 
 namespace cm
@@ -1090,31 +2459,25 @@ namespace cm
         updateMqttTopics();
         lmg.log(LL::Info, "Connected");
 
-        if (!topicSetShowerTime.isEmpty())
-            mqtt.subscribe(topicSetShowerTime.c_str());
-        if (!topicWillShower.isEmpty())
-            mqtt.subscribe(topicWillShower.c_str());
-        if (!topicBoilerEnabled.isEmpty())
-            mqtt.subscribe(topicBoilerEnabled.c_str());
-        if (!topicOnThreshold.isEmpty())
-            mqtt.subscribe(topicOnThreshold.c_str());
-        if (!topicOffThreshold.isEmpty())
-            mqtt.subscribe(topicOffThreshold.c_str());
-        if (!topicStopTimerOnTarget.isEmpty())
-            mqtt.subscribe(topicStopTimerOnTarget.c_str());
-        if (!topicOncePerPeriod.isEmpty())
-            mqtt.subscribe(topicOncePerPeriod.c_str());
-        if (!topicYouCanShowerPeriodMin.isEmpty())
-            mqtt.subscribe(topicYouCanShowerPeriodMin.c_str());
-        if (!topicSave.isEmpty())
-            mqtt.subscribe(topicSave.c_str());
+        if (mqttTopics.ready())
+        {
+            for (const MqttTopic t : SUBSCRIBED_TOPICS)
+            {
+                mqtt.subscribe(mqttTopics.get(t));
+            }
+        }
 
+        // The broker saw nothing while we were offline: forget what the cache thinks it has sent
+        publishCache.invalidate();
         if (!didStartupMQTTPropagate)
         {
             publishMqttState(true);
             didStartupMQTTPropagate = true;
         }
-        publishMqttState(false);
+        else
+        {
+            publishMqttState(false);
+        }
     }
 
     void onMQTTDisconnected()
@@ -1138,84 +2501,151 @@ namespace cm
 // DISPLAY FUNCTIONS
 //----------------------------------------
 
-void WriteToDisplay()
+// One text line segment on the status screen (size 1 font, 6x8 px per glyph).
+struct DisplayField
+{
+    int16_t x;
+    int16_t y;
+    uint8_t maxChars;
+    char text[24];
+};
+
+static DisplayField displayFields[] = {
+    {3, 3, 8, ""},   // relay
+    {51, 3, 12, ""}, // temperature
+    {3, 13, 20, ""}, // remaining time
+};
+
+// Redraw a field only when its text changed and mark its glyph box dirty.
+static void drawDisplayField(DisplayField &field, const char *text)
+{
+    if (strncmp(field.text, text, sizeof(field.text)) == 0)
+    {
+        return;
+    }
+    strncpy(field.text, text, sizeof(field.text) - 1);
+    field.text[sizeof(field.text) - 1] = '\0';
+
+    const int16_t w = min<int16_t>(field.maxChars * 6, 126 - field.x); // keep the frame border
+    display.fillRect(field.x, field.y, w, 8, BLACK);
+    display.setCursor(field.x, field.y);
+    display.print(field.text);
+    displayDirty.markRect(field.x, field.y, w, 8);
+}
+
+// Send only the changed columns of each dirty page (horizontal addressing mode).
+static void flushDisplayDirty()
+{
+    if (displayDirty.commit(display.getBuffer()) == 0)
+    {
+        displayDirty.clear();
+        return;
+    }
+
+    const uint8_t addr = static_cast<uint8_t>(i2cSettings.displayAddr->get());
+    const uint8_t *frame = display.getBuffer();
+    for (uint8_t page = 0; page < DisplayDirtyTracker::PAGES; ++page)
+    {
+        uint8_t first = 0;
+        uint8_t last = 0;
+        if (!displayDirty.span(page, first, last))
+        {
+            continue;
+        }
+        display.ssd1306_command(SSD1306_PAGEADDR);
+        display.ssd1306_command(page);
+        display.ssd1306_command(page);
+        display.ssd1306_command(SSD1306_COLUMNADDR);
+        display.ssd1306_command(first);
+        display.ssd1306_command(last);
+
+        const uint8_t *data = frame + page * DisplayDirtyTracker::WIDTH;
+        uint16_t col = first;
+        while (col <= last)
+        {
+            Wire.beginTransmission(addr);
+            Wire.write(static_cast<uint8_t>(0x40)); // data stream
+            for (uint8_t n = 0; n < DISPLAY_I2C_CHUNK && col <= last; ++n, ++col)
+            {
+                Wire.write(data[col]);
+            }
+            Wire.endTransmission();
+        }
+    }
+    displayDirty.clear();
+}
+
+// Runs in the display task (or inline when it is not running): the only code touching I2C after setup.
+static void WriteToDisplay(const DisplaySnapshot &snap)
 {
-    lmg.scopedTag("DISPLAY");
-    // Static variables to track last displayed values
-    static float lastTemperature = -999.0;
-    static int lastTimeRemainingSec = -1;
-    static bool lastBoilerState = false;
     static bool lastDisplayActive = true;
+    static bool lastPanelOn = true;
 
-    if (displayActive == false)
+    if (snap.panelOn != lastPanelOn)
+    {
+        display.ssd1306_command(snap.panelOn ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF);
+        lastPanelOn = snap.panelOn;
+    }
+
+    if (snap.active == false)
     {
         // If display was just turned off, clear it once
         if (lastDisplayActive == true)
         {
             display.clearDisplay();
             display.display();
+            displayDirty.syncAll(display.getBuffer());
+            for (DisplayField &field : displayFields)
+            {
+                field.text[0] = '\0';
+            }
             lastDisplayActive = false;
         }
         return; // exit the function if the display is not active
     }
 
-    bool wasInactive = !lastDisplayActive;
-    lastDisplayActive = true;
-
-    // Only update display if values have changed
-    bool needsUpdate = wasInactive; // Force refresh on wake
-    int timeLeftSec = boilerTimeRemaining;
-    if (abs(temperature - lastTemperature) > 0.1 ||
-        timeLeftSec != lastTimeRemainingSec ||
-        boilerState != lastBoilerState)
-    {
-        needsUpdate = true;
-        lastTemperature = temperature;
-        lastTimeRemainingSec = timeLeftSec;
-        lastBoilerState = boilerState;
-    }
-
-    if (!needsUpdate)
+    if (!lastDisplayActive)
     {
-        return; // No changes, skip display update
+        // Woken up: the frame border was cleared together with the fields
+        display.drawRect(0, 0, 128, 24, WHITE);
+        displayDirty.markRect(0, 0, 128, 24);
+        lastDisplayActive = true;
     }
 
-    display.fillRect(0, 0, 128, 24, BLACK); // Clear the previous message area
-    display.drawRect(0, 0, 128, 24, WHITE);
-
     display.setTextSize(1);
     display.setTextColor(WHITE);
-
     display.cp437(true); // Use CP437 for extended glyphs (e.g., degree symbol 248)
 
-    // Show boiler status and temperature
-    display.setCursor(3, 3);
+    char buf[24];
+    const float temperature = snap.temperature;
+    snprintf(buf, sizeof(buf), "Relay: %s", snap.relayOn ? "1" : "0");
+    drawDisplayField(displayFields[0], buf);
+
     if (temperature > 0)
     {
-        display.printf("Relay: %s | T:%.1f ", boilerState ? "1" : "0", temperature);
-        display.write((uint8_t)248); // degree symbol in CP437
-        display.print("C");
+        snprintf(buf, sizeof(buf), " | T:%.1f %cC", temperature, (char)248); // 248 = degree symbol in CP437
     }
     else
     {
-        display.printf("Relay: %s", boilerState ? "On " : "Off");
+        snprintf(buf, sizeof(buf), " | T: --");
     }
+    drawDisplayField(displayFields[1], buf);
 
-    // Show remaining time
-    display.setCursor(3, 13);
+    const int timeLeftSec = snap.timeRemainingSec;
+    buf[0] = '\0';
     if (timeLeftSec > 0)
     {
         int h = timeLeftSec / 3600;
         int mm = (timeLeftSec % 3600) / 60;
         int ss = timeLeftSec % 60;
-        display.printf("Time R: %d:%02d:%02d", h, mm, ss);
+        snprintf(buf, sizeof(buf), "Time R: %d:%02d:%02d", h, mm, ss);
     }
-    else
+    drawDisplayField(displayFields[2], buf);
+
+    if (displayDirty.dirty())
     {
-        display.printf("");
+        flushDisplayDirty();
     }
-
-    display.display();
 }
 
 static void SetupStartDisplay()
@@ -1231,35 +2661,67 @@ static void SetupStartDisplay()
     display.setCursor(10, 4);
     display.println("Start");
     display.display();
+    displayDirty.syncAll(display.getBuffer());
+
+    // First status frame replaces the start screen: clear inside the border, then draw fields
+    display.fillRect(1, 1, 126, 22, BLACK);
+    displayDirty.markRect(1, 1, 126, 22);
+}
+
+static void displayTaskMain(void *)
+{
+    DisplaySnapshot snap = {};
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (displayMailbox.take(snap))
+        {
+            WriteToDisplay(snap);
+        }
+    }
+}
+
+static void startDisplayTask()
+{
+#if BOILER_DISPLAY_TASK
+    if (xTaskCreatePinnedToCore(displayTaskMain, "display", 4096, nullptr, 1, &displayTaskHandle, DISPLAY_TASK_CORE) != pdPASS)
+    {
+        displayTaskHandle = nullptr;
+        lmg.logTag(LL::Warn, "DISPLAY", "Display task not started -> rendering inline");
+    }
+#endif
 }
 
 void ShowDisplay()
 {
     displayTicker.detach();                                                 // Stop the ticker to prevent multiple calls
-    display.ssd1306_command(SSD1306_DISPLAYON);                             // Turn on the display
+    displayPanelOn = true;                                                  // Turn on the display (applied by the renderer)
     displayTicker.attach(displaySettings.onTimeSec->get(), ShowDisplayOff); // Reattach the ticker to turn off the display after the specified time
     displayActive = true;
+    wakeLoop(loopTasks.display);
 }
 
 void ShowDisplayOff()
 {
     displayTicker.detach();                      // Stop the ticker to prevent multiple calls
 
-    if (willShowerRequested)
+    if (boiler.willShowerRequested())
     {
-        display.ssd1306_command(SSD1306_DISPLAYON);
+        displayPanelOn = true;
         displayActive = true;
         displayTicker.attach(displaySettings.onTimeSec->get(), ShowDisplayOff);
+        wakeLoop(loopTasks.display);
         return;
     }
 
-    display.ssd1306_command(SSD1306_DISPLAYOFF); // Turn off the display
+    displayPanelOn = false; // Turn off the display (applied by the renderer)
     // display.fillRect(0, 0, 128, 24, BLACK); // Clear the previous message area
 
     if (displaySettings.turnDisplayOff->get())
     {
         displayActive = false;
     }
+    wakeLoop(loopTasks.display);
 }
 
 
@@ -1326,37 +2788,325 @@ void onWiFiAPMode()
 }
 
 //----------------------------------------
-// Shower request handler (UI/MQTT helper)
+// Input commands
 //----------------------------------------
-static void handleShowerRequest(bool v)
+static const char *commandName(CommandType type)
 {
-    lmg.scopedTag("handleShowerRequest");
-    willShowerRequested = v;
-    if (v)
+    switch (type)
+    {
+    case CommandType::SetShowerTime:
+        return "SetShowerTime";
+    case CommandType::WillShower:
+        return "WillShower";
+    case CommandType::ToggleShower:
+        return "ToggleShower";
+    case CommandType::SetEnabled:
+        return "SetEnabled";
+    case CommandType::SetOnThreshold:
+        return "SetOnThreshold";
+    case CommandType::SetOffThreshold:
+        return "SetOffThreshold";
+    case CommandType::SetShowerPeriod:
+        return "SetShowerPeriod";
+    case CommandType::SetStopOnTarget:
+        return "SetStopOnTarget";
+    case CommandType::SetOncePerPeriod:
+        return "SetOncePerPeriod";
+    case CommandType::Save:
+        return "Save";
+    }
+    return "?";
+}
+
+// Safe from any task: lock-free enqueue, then wake the loop. A full queue drops the command.
+static bool postCommand(CommandType type, CommandSource source, bool b, int32_t i, float f)
+{
+    const BoilerCommand command = {type, source, b, i, f, millis()};
+    if (!commandQueue.push(command))
+    {
+        lmg.log(LL::Warn, "Command queue full, dropped %s", commandName(type));
+        return false;
+    }
+    wakeLoop(loopTasks.command);
+    return true;
+}
+
+static void applyCommand(const BoilerCommand &c)
+{
+    switch (c.type)
+    {
+    case CommandType::SetShowerTime:
+        boiler.startShowerTimer(c.i);
+        ShowDisplay();
+        lmg.log(LL::Debug, "MQTT set shower time: %ld min (relay ON)", (long)c.i);
+        if (mqtt.isConnected())
+        {
+            mqtt.publish(mqttTopics.get(MT::WillShower), "1", true);
+        }
+        break;
+
+    case CommandType::WillShower:
+        if (c.source != CommandSource::Mqtt)
+        {
+            handleShowerRequest(c.b);
+            break;
+        }
+        if (c.b == boiler.willShowerRequested())
+        {
+            break;
+        }
+        boiler.setShowerRequest(c.b);
+        if (c.b)
+        {
+            ShowDisplay();
+            lmg.log(LL::Debug, "HA request: will shower -> %d s left (relay ON)", boiler.timeRemaining());
+        }
+        else
+        {
+            lmg.log(LL::Debug, "HA request: will shower = false -> timer cleared, relay OFF");
+        }
+        break;
+
+    case CommandType::ToggleShower:
     {
-        if (boilerTimeRemaining <= 0)
+        if (!displayActive)
         {
-            int mins = boilerSettings.boilerTimeMin->get();
-            if (mins <= 0)
-                mins = 60;
-            boilerTimeRemaining = mins * 60;
+            lmg.log(LL::Debug, "[MAIN] Shower button pressed while display OFF -> wake display only");
+            ShowDisplay();
+            break;
         }
-        setBoilerState(true);
+        const bool newState = !boiler.willShowerRequested();
+        lmg.log(LL::Debug, "[MAIN] Shower button pressed -> toggling shower request to %s", newState ? "ON" : "OFF");
         ShowDisplay();
-        if (mqtt.isConnected() && !topicWillShower.isEmpty())
+        handleShowerRequest(newState);
+        break;
+    }
+
+    case CommandType::SetEnabled:
+        boilerSettings.enabled->set(c.b);
+        lmg.log(LL::Debug, "BoilerEnabled set to %s", c.b ? "true" : "false");
+        break;
+
+    case CommandType::SetOnThreshold:
+        boilerSettings.onThreshold->set(c.f);
+        lmg.log(LL::Debug, "OnThreshold set to %.1f", c.f);
+        break;
+
+    case CommandType::SetOffThreshold:
+        boilerSettings.offThreshold->set(c.f);
+        lmg.log(LL::Debug, "OffThreshold set to %.1f", c.f);
+        break;
+
+    case CommandType::SetShowerPeriod:
+        boilerSettings.boilerTimeMin->set(static_cast<int>(c.i));
+        lmg.log(LL::Debug, "BoilerTimeMin set to %ld", (long)c.i);
+        boiler.resetShowerNotice();
+        break;
+
+    case CommandType::SetStopOnTarget:
+        boilerSettings.stopTimerOnTarget->set(c.b);
+        lmg.log(LL::Debug, "StopTimerOnTarget set to %s", c.b ? "true" : "false");
+        break;
+
+    case CommandType::SetOncePerPeriod:
+        boilerSettings.onlyOncePerPeriod->set(c.b);
+        lmg.log(LL::Debug, "OncePerPeriod set to %s", c.b ? "true" : "false");
+        boiler.resetShowerNotice();
+        break;
+
+    case CommandType::Save:
+        trackPersistedSettings(true); // written by taskPersist once the debounce window closes
+        break;
+    }
+}
+
+// Single drain point for all inputs.
+static void taskCommand()
+{
+    LOOP_STAGE(command);
+    BoilerCommand c;
+    while (commandQueue.pop(c))
+    {
+        applyingCommand = true;
+        applyCommand(c);
+        applyingCommand = false;
+        trackPersistedSettings(false);
+        const uint32_t latencyMs = millis() - c.queuedMs;
+        commandLatencyLastMs = latencyMs;
+        if (latencyMs > commandLatencyMaxMs)
         {
-            mqtt.publish(topicWillShower.c_str(), "1", true);
+            commandLatencyMaxMs = latencyMs;
         }
+        commandsHandled++;
     }
-    else
+}
+
+//----------------------------------------
+// Settings persistence
+//----------------------------------------
+static uint32_t persistFingerprint(uint8_t key)
+{
+    const auto floatBits = [](float v)
+    {
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return bits;
+    };
+    switch (key)
+    {
+    case PK_ENABLED:
+        return boilerSettings.enabled->get() ? 1 : 0;
+    case PK_ON_THRESHOLD:
+        return floatBits(boilerSettings.onThreshold->get());
+    case PK_OFF_THRESHOLD:
+        return floatBits(boilerSettings.offThreshold->get());
+    case PK_BOILER_TIME:
+        return static_cast<uint32_t>(boilerSettings.boilerTimeMin->get());
+    case PK_STOP_ON_TARGET:
+        return boilerSettings.stopTimerOnTarget->get() ? 1 : 0;
+    case PK_ONCE_PER_PERIOD:
+        return boilerSettings.onlyOncePerPeriod->get() ? 1 : 0;
+    }
+    return 0;
+}
+
+static void persistKey(uint8_t key)
+{
+    switch (key)
+    {
+    case PK_ENABLED:
+        boilerSettings.enabled->save(boilerSettings.enabled->get());
+        break;
+    case PK_ON_THRESHOLD:
+        boilerSettings.onThreshold->save(boilerSettings.onThreshold->get());
+        break;
+    case PK_OFF_THRESHOLD:
+        boilerSettings.offThreshold->save(boilerSettings.offThreshold->get());
+        break;
+    case PK_BOILER_TIME:
+        boilerSettings.boilerTimeMin->save(boilerSettings.boilerTimeMin->get());
+        break;
+    case PK_STOP_ON_TARGET:
+        boilerSettings.stopTimerOnTarget->save(boilerSettings.stopTimerOnTarget->get());
+        break;
+    case PK_ONCE_PER_PERIOD:
+        boilerSettings.onlyOncePerPeriod->save(boilerSettings.onlyOncePerPeriod->get());
+        break;
+    }
+}
+
+// Flash now matches RAM for every tracked key (after loadAll() or a full save).
+static void markSettingsStored()
+{
+    settingsChangedMask.store(0);
+    for (uint8_t k = 0; k < PK_COUNT; ++k)
+    {
+        settingsPersist.setStored(k, persistFingerprint(k));
+    }
+}
+
+// Called from the setting callbacks. A change from the web UI is saved by the settings manager on
+// its own, so the tracker can no longer assume it knows what is in flash for this key. A set()
+// from applyCommand() (MQTT, buttons) is left to the tracker: its stored fingerprint stays valid,
+// so only a value that really differs from flash gets written.
+static void noteSettingChanged(uint8_t key)
+{
+    if (applyingCommand && xTaskGetCurrentTaskHandle() == loopTaskHandle)
+    {
+        return;
+    }
+    settingsChangedMask.fetch_or(1u << key);
+}
+
+// Feed the current values to the tracker; flush = a Save request. Schedules the persist task.
+static void trackPersistedSettings(bool flush)
+{
+    const uint32_t now = millis();
+    const uint32_t changed = settingsChangedMask.exchange(0);
+    for (uint8_t k = 0; k < PK_COUNT; ++k)
+    {
+        if (changed & (1u << k))
+        {
+            settingsPersist.forgetStored(k);
+        }
+        settingsPersist.update(k, persistFingerprint(k), now);
+    }
+    if (flush)
+    {
+        settingsPersist.requestFlush(now);
+    }
+    const uint32_t due = settingsPersist.nextDueMs(now);
+    if (due != UINT32_MAX)
     {
-        // user canceled
-        boilerTimeRemaining = 0;
-        setBoilerState(false);
-        if (mqtt.isConnected() && !topicWillShower.isEmpty())
+        loopScheduler.scheduleAt(loopTasks.persist, due);
+    }
+}
+
+// Writes one key per loop pass. A flash write stalls the cache of both cores on the ESP32, so
+// moving it to another task would not take it off the control path; keeping each pass to a
+// single write lets the sensor and boiler tasks run between writes.
+static void taskPersist()
+{
+    LOOP_STAGE(persist);
+    static uint32_t writing = 0; // keys taken from the tracker, not yet written
+    static uint8_t written = 0;
+    const uint32_t now = millis();
+    if (writing == 0)
+    {
+        if (!settingsPersist.flushPending())
+        {
+            return;
+        }
+        writing = settingsPersist.takeDue(now);
+        if (settingsPersist.flushPending())
         {
-            mqtt.publish(topicWillShower.c_str(), "0", true);
+            loopScheduler.scheduleAt(loopTasks.persist, settingsPersist.nextDueMs(now)); // window moved on
+            return;
         }
+        written = 0;
+    }
+    for (uint8_t k = 0; k < PK_COUNT; ++k)
+    {
+        if (writing & (1u << k))
+        {
+            persistKey(k);
+            writing &= ~(1u << k);
+            written++;
+            break;
+        }
+    }
+    if (writing != 0)
+    {
+        loopScheduler.trigger(loopTasks.persist);
+        return;
+    }
+    if (mqtt.isConnected())
+    {
+        mqtt.publish(mqttTopics.get(MT::Save), "OK", false);
+    }
+    lmg.log(LL::Info, "[MAIN] Settings saved via MQTT (%u changed key(s) written, %lu writes avoided so far)",
+            (unsigned)written, (unsigned long)settingsPersist.writesAvoided());
+}
+
+//----------------------------------------
+// Shower request handler (UI/MQTT helper)
+//----------------------------------------
+static void handleShowerRequest(bool v)
+{
+    lmg.scopedTag("handleShowerRequest");
+    syncBoilerConfig();
+    boiler.setShowerRequest(v);
+    if (v)
+    {
+        ShowDisplay();
+    }
+    else
+    {
+        wakeLoop(loopTasks.display);
+    }
+    if (mqtt.isConnected() && mqttTopics.ready())
+    {
+        mqtt.publish(mqttTopics.get(MT::WillShower), v ? "1" : "0", true);
     }
 }
 
@@ -1365,8 +3115,7 @@ static void setupNetworkDefaults()
 #if CM_HAS_WIFI_SECRETS && defined(WIFI_FILTER_MAC_PRIORITY)
     if (wifiUiSettings.apMacPriority != nullptr && wifiUiSettings.apMacPriority->get().isEmpty())
     {
-        wifiUiSettings.apMacPriority->set(String(WIFI_FILTER_MAC_PRIORITY));
-        ConfigManager.saveAll();
+        wifiUiSettings.apMacPriority->save(String(WIFI_FILTER_MAC_PRIORITY));
     }
 #endif
 
@@ -1376,26 +3125,25 @@ static void setupNetworkDefaults()
         Serial.println("-------------------------------------------------------------");
         Serial.println("SETUP: *** SSID is empty, setting My values *** ");
         Serial.println("-------------------------------------------------------------");
-        wifiSettings.wifiSsid.set(MY_WIFI_SSID);
-        wifiSettings.wifiPassword.set(MY_WIFI_PASSWORD);
+        wifiSettings.wifiSsid.save(MY_WIFI_SSID);
+        wifiSettings.wifiPassword.save(MY_WIFI_PASSWORD);
 
         // Optional secret fields (not present in every example).
 #ifdef MY_WIFI_IP
-        wifiSettings.staticIp.set(MY_WIFI_IP);
+        wifiSettings.staticIp.save(MY_WIFI_IP);
 #endif
 #ifdef MY_USE_DHCP
-        wifiSettings.useDhcp.set(MY_USE_DHCP);
+        wifiSettings.useDhcp.save(MY_USE_DHCP);
 #endif
 #ifdef MY_GATEWAY_IP
-        wifiSettings.gateway.set(MY_GATEWAY_IP);
+        wifiSettings.gateway.save(MY_GATEWAY_IP);
 #endif
 #ifdef MY_SUBNET_MASK
-        wifiSettings.subnet.set(MY_SUBNET_MASK);
+        wifiSettings.subnet.save(MY_SUBNET_MASK);
 #endif
 #ifdef MY_DNS_IP
-        wifiSettings.dnsPrimary.set(MY_DNS_IP);
+        wifiSettings.dnsPrimary.save(MY_DNS_IP);
 #endif
-        ConfigManager.saveAll();
         Serial.println("-------------------------------------------------------------");
         Serial.println("Restarting ESP, after auto setting WiFi credentials");
         Serial.println("-------------------------------------------------------------");
@@ -1413,16 +3161,15 @@ static void setupNetworkDefaults()
         lmg.log(LL::Debug, "-------------------------------------------------------------");
         lmg.log(LL::Debug, "SETUP: *** MQTT Broker is empty, setting My values *** ");
         lmg.log(LL::Debug, "-------------------------------------------------------------");
-        mqttSettings.server.set(MY_MQTT_BROKER_IP);
-        mqttSettings.port.set(MY_MQTT_BROKER_PORT);
+        mqttSettings.server.save(MY_MQTT_BROKER_IP);
+        mqttSettings.port.save(MY_MQTT_BROKER_PORT);
 #ifdef MY_MQTT_USERNAME
-        mqttSettings.username.set(MY_MQTT_USERNAME);
+        mqttSettings.username.save(MY_MQTT_USERNAME);
 #endif
 #ifdef MY_MQTT_PASSWORD
-        mqttSettings.password.set(MY_MQTT_PASSWORD);
+        mqttSettings.password.save(MY_MQTT_PASSWORD);
 #endif
-        mqttSettings.publishTopicBase.set(MY_MQTT_ROOT);
-        ConfigManager.saveAll();
+        mqttSettings.publishTopicBase.save(MY_MQTT_ROOT);
         lmg.log(LL::Debug, "-------------------------------------------------------------");
 #else
         lmg.log(LL::Info, "SETUP: MQTT server is empty; secret/secrets.h does not provide MQTT defaults for this example");
@@ -1438,6 +3185,372 @@ static void setupNetworkDefaults()
     }
 }
 
+static void setupLoopProfiler()
+{
+    loopProfiler.setCyclesPerUs(getCpuFrequencyMhz());
+    loopStages.wifi = loopProfiler.addStage("wifi");
+    loopStages.io = loopProfiler.addStage("io");
+    loopStages.sensor = loopProfiler.addStage("sensor");
+    loopStages.web = loopProfiler.addStage("web");
+    loopStages.alarm = loopProfiler.addStage("alarm");
+    loopStages.display = loopProfiler.addStage("display");
+    loopStages.mqtt = loopProfiler.addStage("mqtt");
+    loopStages.logging = loopProfiler.addStage("logging");
+    loopStages.publish = loopProfiler.addStage("publish");
+    loopStages.boiler = loopProfiler.addStage("boiler");
+    loopStages.led = loopProfiler.addStage("led");
+    loopStages.snapshot = loopProfiler.addStage("snapshot");
+    loopStages.command = loopProfiler.addStage("command");
+    loopStages.persist = loopProfiler.addStage("persist");
+    loopStages.boot = loopProfiler.addStage("boot");
+    loopStages.total = loopProfiler.addStage("loop");
+
+#if BOILER_LOOP_PROFILER
+    auto perfCard = ConfigManager.liveGroup("Perf")
+                        .page("Perf", 90)
+                        .card("Loop timing", 10);
+
+    perfCard.value("Pf_LoopP50", []()
+                   { return (int)loopProfiler.toUs(loopProfiler.histogram(loopStages.total).percentile(50.0f)); })
+        .label("Loop p50")
+        .unit("us")
+        .precision(0)
+        .order(1);
+
+    perfCard.value("Pf_LoopP99", []()
+                   { return (int)loopProfiler.toUs(loopProfiler.histogram(loopStages.total).percentile(99.0f)); })
+        .label("Loop p99")
+        .unit("us")
+        .precision(0)
+        .order(2);
+
+    perfCard.value("Pf_LoopMax", []()
+                   { return (int)loopProfiler.toUs(loopProfiler.histogram(loopStages.total).max()); })
+        .label("Loop max")
+        .unit("us")
+        .precision(0)
+        .order(3);
+
+    perfCard.value("Pf_Slowest", []()
+                   { return String(loopProfiler.stageName(loopProfiler.slowestStage(loopStages.total))); })
+        .label("Slowest stage (p99)")
+        .order(4);
+
+    perfCard.value("Pf_WakeRate", []()
+                   {
+            // loop() wakeups per second since the previous poll of this value
+            static uint32_t lastPasses = 0;
+            static uint32_t lastMs = 0;
+            const uint32_t now = millis();
+            const uint32_t passes = loopScheduler.passCount();
+            const float rate = (now != lastMs) ? (passes - lastPasses) * 1000.0f / (now - lastMs) : 0.0f;
+            lastPasses = passes;
+            lastMs = now;
+            return rate; })
+        .label("Loop wakeups")
+        .unit("1/s")
+        .precision(1)
+        .order(5);
+
+    perfCard.value("Pf_Late", []()
+                   { return (int)loopScheduler.lateCount(); })
+        .label("Missed deadlines")
+        .precision(0)
+        .order(6);
+#endif
+}
+
+// Append the control temperature every historyInterval seconds (only with a valid wall clock).
+static void recordHistory(uint32_t nowMs)
+{
+    static uint32_t lastMs = 0;
+    static bool recorded = false;
+    const uint32_t intervalMs = static_cast<uint32_t>(max(1, tempSensorSettings.historyInterval->get())) * 1000UL;
+    if (recorded && nowMs - lastMs < intervalMs)
+    {
+        return;
+    }
+    const time_t epoch = time(nullptr);
+    if (epoch < 24 * 60 * 60)
+    {
+        return; // NTP not synced yet
+    }
+    xSemaphoreTake(historyLock, portMAX_DELAY);
+    history.append(static_cast<uint32_t>(epoch), boiler.temperature(), getBoilerState());
+    xSemaphoreGive(historyLock);
+    lastMs = nowMs;
+    recorded = true;
+}
+
+static uint32_t historyParam(AsyncWebServerRequest *request, const char *name, uint32_t fallback)
+{
+    if (!request->hasParam(name))
+    {
+        return fallback;
+    }
+    return static_cast<uint32_t>(strtoul(request->getParam(name)->value().c_str(), nullptr, 10));
+}
+
+// The async web task must not wait on loop() for long; a busy lock means "try the chunk again".
+static constexpr TickType_t WEB_LOCK_TIMEOUT = pdMS_TO_TICKS(20);
+
+// Stream samples in [from, to] as CSV lines or raw HistoryRing blocks, chunk by chunk.
+static void sendHistory(AsyncWebServerRequest *request, bool binary)
+{
+    struct Stream
+    {
+        HistoryRing::Cursor cursor;
+        uint32_t to;
+        bool headerSent;
+    };
+    const uint32_t from = historyParam(request, "from", 0);
+    auto stream = std::make_shared<Stream>();
+    stream->to = historyParam(request, "to", UINT32_MAX);
+    stream->headerSent = binary; // binary has no header line
+    if (xSemaphoreTake(historyLock, WEB_LOCK_TIMEOUT) != pdTRUE)
+    {
+        request->send(503, "text/plain", "busy");
+        return;
+    }
+    stream->cursor = history.seek(from);
+    xSemaphoreGive(historyLock);
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse(
+        binary ? "application/octet-stream" : "text/csv",
+        [stream, binary](uint8_t *buf, size_t maxLen, size_t) -> size_t
+        {
+            if (!stream->headerSent)
+            {
+                static const char HEADER[] = "time,temp,relay\n";
+                if (maxLen < sizeof(HEADER) - 1)
+                {
+                    return RESPONSE_TRY_AGAIN; // 0 would end the response
+                }
+                memcpy(buf, HEADER, sizeof(HEADER) - 1);
+                stream->headerSent = true;
+                return sizeof(HEADER) - 1;
+            }
+            if (xSemaphoreTake(historyLock, WEB_LOCK_TIMEOUT) != pdTRUE)
+            {
+                return RESPONSE_TRY_AGAIN;
+            }
+            size_t n = binary ? history.copyBlocks(stream->cursor, stream->to, buf, maxLen)
+                              : history.writeCsv(stream->cursor, stream->to, reinterpret_cast<char *>(buf), maxLen);
+            if (n == 0)
+            {
+                // Only whole lines/blocks are written: tell "no room in this buffer" from the end
+                HistoryRing::Cursor peek = stream->cursor;
+                HistoryRing::Sample sample;
+                if (history.next(peek, sample) && sample.time <= stream->to)
+                {
+                    n = RESPONSE_TRY_AGAIN;
+                }
+            }
+            xSemaphoreGive(historyLock);
+            return n;
+        });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+static void setupSessionLog()
+{
+    lmg.scopedTag("SETUP/SESSIONS");
+    sessionLock = xSemaphoreCreateMutex();
+    if (!LittleFS.begin(true))
+    {
+        lmg.log(LL::Error, "LittleFS mount failed -> session log disabled");
+        return;
+    }
+    LittleFS.mkdir(LittleFsSessionStorage::DIR);
+    const uint32_t startUs = micros();
+    const uint32_t records = sessionLog.begin();
+    lmg.log(LL::Info, "Session log: %lu sessions in %u segments (indexed in %lu us)",
+            (unsigned long)records, sessionLog.segmentCount(), (unsigned long)(micros() - startUs));
+    sessionLogReady = true;
+    if (esp_register_shutdown_handler(flushSessionsOnShutdown) != ESP_OK)
+    {
+        lmg.log(LL::Warn, "Shutdown hook not registered -> held sessions are lost on restart");
+    }
+
+    for (uint32_t i = records > PREHEAT_SEED_SESSIONS ? records - PREHEAT_SEED_SESSIONS : 0; i < records; ++i)
+    {
+        SessionRecord record;
+        if (sessionLog.read(i, record))
+        {
+            learnPreheat(record);
+        }
+    }
+    lmg.log(LL::Info, "Pre-heat model: %u sessions", preheatModel.sessions());
+}
+
+// Runs from esp_restart() (OTA, factory reset, WiFi setup restart): write held sessions now.
+// The lock wait is bounded in case the restarting task already holds it.
+static void flushSessionsOnShutdown()
+{
+    if (!sessionLogReady || sessionLog.pendingCount() == 0)
+    {
+        return;
+    }
+    if (xSemaphoreTake(sessionLock, pdMS_TO_TICKS(200)) != pdTRUE)
+    {
+        return;
+    }
+    sessionLog.flush();
+    xSemaphoreGive(sessionLock);
+}
+
+// Sessions that started below the target and reached it feed the heat-up curve.
+static void learnPreheat(const SessionRecord &record)
+{
+    if (record.heatMinutes != SessionRecord::HEAT_UNKNOWN && record.heatMinutes > 0)
+    {
+        preheatModel.addSession(record.startTemp, record.heatMinutes);
+    }
+}
+
+// Close heating sessions from the per-second boiler state and batch them into the flash log.
+static void trackSession()
+{
+    const uint32_t now = millis();
+    const time_t epoch = time(nullptr);
+    const bool relayOn = getBoilerState();
+    const bool requested = relayOn || (boiler.timeRemaining() > 0 && boiler.config().enabled);
+    SessionRecord record;
+    if (sessionTracker.update(now, epoch > 24 * 60 * 60 ? static_cast<uint32_t>(epoch) : 0, relayOn, requested,
+                              boiler.temperature(), boilerSettings.offThreshold->get(),
+                              static_cast<uint8_t>(boiler.lastStopReason()), record))
+    {
+        lmg.log(LL::Info, "Heating session: %u min on, %.1f -> %.1f°C, stop: %s", record.onMinutes,
+                record.startTemp, record.endTemp, stopReasonName(boiler.lastStopReason()));
+        learnPreheat(record);
+        if (sessionLogReady)
+        {
+            xSemaphoreTake(sessionLock, portMAX_DELAY);
+            sessionLog.append(record, now);
+            xSemaphoreGive(sessionLock);
+        }
+    }
+
+    if (sessionLogReady && sessionLog.pendingCount() > 0)
+    {
+        const uint32_t holdMs = static_cast<uint32_t>(max(0, boilerSettings.sessionFlushMin->get())) * 60000UL;
+        xSemaphoreTake(sessionLock, portMAX_DELAY);
+        if (!sessionLog.flushDue(now, holdMs))
+        {
+            lmg.log(LL::Error, "Session log write failed (%lu errors)", (unsigned long)sessionLog.writeErrors());
+        }
+        xSemaphoreGive(sessionLock);
+    }
+}
+
+// All logged sessions as CSV, oldest first, streamed chunk by chunk.
+static void sendSessions(AsyncWebServerRequest *request)
+{
+    auto next = std::make_shared<int32_t>(-1); // -1 = header line
+    AsyncWebServerResponse *response = request->beginChunkedResponse(
+        "text/csv",
+        [next](uint8_t *buf, size_t maxLen, size_t) -> size_t
+        {
+            char *out = reinterpret_cast<char *>(buf);
+            size_t used = 0;
+            if (xSemaphoreTake(sessionLock, WEB_LOCK_TIMEOUT) != pdTRUE)
+            {
+                return RESPONSE_TRY_AGAIN;
+            }
+            while (true)
+            {
+                char line[96];
+                int len;
+                if (*next < 0)
+                {
+                    len = snprintf(line, sizeof(line), "start,end,on_min,heat_min,start_temp,end_temp,reason\n");
+                }
+                else
+                {
+                    SessionRecord r;
+                    if (static_cast<uint32_t>(*next) >= sessionLog.size())
+                    {
+                        break;
+                    }
+                    if (!sessionLog.read(static_cast<uint32_t>(*next), r))
+                    {
+                        (*next)++; // skip corrupt records
+                        continue;
+                    }
+                    len = snprintf(line, sizeof(line), "%lu,%lu,%u,%d,%.2f,%.2f,%s\n",
+                                   (unsigned long)r.startTime, (unsigned long)r.endTime, r.onMinutes,
+                                   r.heatMinutes == SessionRecord::HEAT_UNKNOWN ? -1 : (int)r.heatMinutes,
+                                   r.startTemp, r.endTemp, stopReasonName(static_cast<StopReason>(r.reason)));
+                }
+                if (used + len > maxLen)
+                {
+                    if (used == 0)
+                    {
+                        used = RESPONSE_TRY_AGAIN; // 0 would end the response
+                    }
+                    break;
+                }
+                memcpy(out + used, line, len);
+                used += len;
+                (*next)++;
+            }
+            xSemaphoreGive(sessionLock);
+            return used;
+        });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+static void setupApiServer()
+{
+    lmg.scopedTag("API");
+
+    // Prebuilt by the snapshot task; concurrent clients only copy the current buffer
+    apiServer.on("/runtime.json", HTTP_GET, [](AsyncWebServerRequest *request)
+                 {
+        char body[decltype(runtimeJson)::CAPACITY];
+        if (runtimeJson.read(body, sizeof(body)) == 0)
+        {
+            request->send(503, "text/plain", "snapshot not ready");
+            return;
+        }
+        runtimeSnapshotServed++;
+        AsyncWebServerResponse *response = request->beginResponse(200, "application/json", body);
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response); });
+    // SSE: a new client gets the full snapshot, then only the deltas from the snapshot task
+    runtimeEvents.onConnect([](AsyncEventSourceClient *client)
+                            {
+        char body[decltype(runtimeJson)::CAPACITY];
+        if (runtimeJson.read(body, sizeof(body)) > 0)
+        {
+            client->send(body, "full", runtimeJson.version());
+        } });
+    apiServer.addHandler(&runtimeEvents);
+    apiServer.on("/perf.json", HTTP_GET, [](AsyncWebServerRequest *request)
+                 {
+        static char perfJson[1536];
+        loopProfiler.writeJson(perfJson, sizeof(perfJson));
+        request->send(200, "application/json", perfJson); });
+
+    apiServer.on("/perf/reset", HTTP_POST, [](AsyncWebServerRequest *request)
+                 {
+        loopProfiler.reset();
+        request->send(200, "text/plain", "OK"); });
+
+    // History range queries: ?from=<epoch>&to=<epoch> (both optional)
+    apiServer.on("/history.csv", HTTP_GET, [](AsyncWebServerRequest *request)
+                 { sendHistory(request, false); });
+    apiServer.on("/history.bin", HTTP_GET, [](AsyncWebServerRequest *request)
+                 { sendHistory(request, true); });
+    apiServer.on("/sessions.csv", HTTP_GET, [](AsyncWebServerRequest *request)
+                 { sendSessions(request); });
+
+    apiServer.begin();
+    lmg.log(LL::Debug, "API server on port %d", APP_API_PORT);
+}
+
 static void applyWiFiMacPriority()
 {
     if (wifiUiSettings.apMacPriority == nullptr)
@@ -6,6 +6,8 @@ DisplaySettings displaySettings;
 BoilerSettings boilerSettings;
 TempSensorSettings tempSensorSettings;
 WiFiUiSettings wifiUiSettings;
+PublishSettings publishSettings;
+ScheduleSettings scheduleSettings;
 
 // Function to register all settings with ConfigManager
 // This solves the static initialization order problem
@@ -15,4 +17,6 @@ void initializeAllSettings() {
     displaySettings.create();
     tempSensorSettings.create();
     wifiUiSettings.create();
+    publishSettings.create();
+    scheduleSettings.create();
 }
@@ -53,6 +53,11 @@ struct BoilerSettings {
     Config<int> *boilerTimeMin = nullptr;  // max time boiler is allowed to heat
     Config<bool> *stopTimerOnTarget = nullptr; // stop timer when off-threshold reached
     Config<bool> *onlyOncePerPeriod = nullptr; // publish '1' only once per period
+    Config<bool> *earlyStop = nullptr;         // stop heating early using the learned overshoot
+    Config<int> *sessionFlushMin = nullptr;    // max minutes a finished session waits in RAM before the flash write
+    Config<int> *minOnSec = nullptr;           // anti-short-cycle: minimum relay on time
+    Config<int> *minOffSec = nullptr;          // anti-short-cycle: minimum relay off time
+    Config<int> *maxStartsPerHour = nullptr;   // burner start budget (0 = unlimited)
 
     void create()
     {
@@ -86,6 +91,31 @@ struct BoilerSettings {
                                  .category("Boiler")
                                  .defaultValue(true)
                                  .build();
+        earlyStop = &ConfigManager.addSettingBool("BoI_Early")
+                         .name("Predictive early stop")
+                         .category("Boiler")
+                         .defaultValue(false)
+                         .build();
+        sessionFlushMin = &ConfigManager.addSettingInt("BoI_LogHold")
+                               .name("Session log flush delay (min)")
+                               .category("Boiler")
+                               .defaultValue(5)
+                               .build();
+        minOnSec = &ConfigManager.addSettingInt("BoI_MinOn")
+                        .name("Relay minimum on time (s)")
+                        .category("Boiler")
+                        .defaultValue(60)
+                        .build();
+        minOffSec = &ConfigManager.addSettingInt("BoI_MinOff")
+                         .name("Relay minimum off time (s)")
+                         .category("Boiler")
+                         .defaultValue(120)
+                         .build();
+        maxStartsPerHour = &ConfigManager.addSettingInt("BoI_MaxSt")
+                                .name("Max burner starts per hour (0 = off)")
+                                .category("Boiler")
+                                .defaultValue(6)
+                                .build();
     }
 };
 
@@ -110,8 +140,22 @@ struct DisplaySettings {
 
 struct TempSensorSettings {
     Config<int> *gpioPin = nullptr;      // DS18B20 data pin
-    Config<float> *corrOffset = nullptr;   // correction offset in °C
+    Config<float> *corrOffset = nullptr;   // correction offset in °C (sensor 1, drives the control)
+    Config<float> *corrOffset2 = nullptr;  // sensor 2 (ROM order on the bus)
+    Config<float> *corrOffset3 = nullptr;  // sensor 3
     Config<int> *readInterval = nullptr; // seconds
+    Config<int> *resolution = nullptr;   // DS18B20 resolution, 9..12 bit
+    Config<int> *oversample = nullptr;   // conversions averaged per sample (1, 2, 4, 8)
+    Config<int> *historyInterval = nullptr; // seconds between samples kept in the RAM history
+    Config<int> *filterMedian = nullptr;    // median window (samples), 1 = off
+    Config<float> *filterAlpha = nullptr;   // EMA weight of a new sample, 1 = off
+    Config<float> *filterMaxRate = nullptr; // rate limit in °C/min, 0 = off
+
+    float offsetFor(uint8_t index) const
+    {
+        const Config<float> *offsets[] = {corrOffset, corrOffset2, corrOffset3};
+        return (index < 3 && offsets[index]) ? offsets[index]->get() : 0.0f;
+    }
 
     void create()
     {
@@ -121,15 +165,123 @@ struct TempSensorSettings {
                        .defaultValue(26)
                        .build();
         corrOffset = &ConfigManager.addSettingFloat("TsOfs")
-                          .name("Correction Offset")
+                          .name("Correction Offset (sensor 1)")
                           .category("Temp Sensor")
                           .defaultValue(15.0f)
                           .build();
+        corrOffset2 = &ConfigManager.addSettingFloat("TsOfs2")
+                           .name("Correction Offset (sensor 2)")
+                           .category("Temp Sensor")
+                           .defaultValue(0.0f)
+                           .build();
+        corrOffset3 = &ConfigManager.addSettingFloat("TsOfs3")
+                           .name("Correction Offset (sensor 3)")
+                           .category("Temp Sensor")
+                           .defaultValue(0.0f)
+                           .build();
         readInterval = &ConfigManager.addSettingInt("TsInt")
                              .name("Read Interval (s)")
                              .category("Temp Sensor")
                              .defaultValue(10)
                              .build();
+        resolution = &ConfigManager.addSettingInt("TsRes")
+                          .name("Resolution (9-12 bit)")
+                          .category("Temp Sensor")
+                          .defaultValue(12)
+                          .build();
+        oversample = &ConfigManager.addSettingInt("TsOvs")
+                          .name("Oversampling (1/2/4/8 reads averaged)")
+                          .category("Temp Sensor")
+                          .defaultValue(1)
+                          .build();
+        historyInterval = &ConfigManager.addSettingInt("TsHist")
+                               .name("History Interval (s)")
+                               .category("Temp Sensor")
+                               .defaultValue(60)
+                               .build();
+        filterMedian = &ConfigManager.addSettingInt("TsMed")
+                            .name("Filter: median window (1 = off)")
+                            .category("Temp Sensor")
+                            .defaultValue(5)
+                            .build();
+        filterAlpha = &ConfigManager.addSettingFloat("TsEma")
+                           .name("Filter: EMA weight (1 = off)")
+                           .category("Temp Sensor")
+                           .defaultValue(0.5f)
+                           .build();
+        filterMaxRate = &ConfigManager.addSettingFloat("TsRate")
+                             .name("Filter: max rate (°C/min, 0 = off)")
+                             .category("Temp Sensor")
+                             .defaultValue(3.0f)
+                             .build();
+    }
+};
+
+struct PublishSettings {
+    Config<float> *tempDeadband = nullptr; // °C change needed before TemperatureBoiler is republished
+    Config<int> *timeStepSec = nullptr;    // TimeRemaining granularity
+    Config<int> *maxSilenceSec = nullptr;  // heartbeat: republish unchanged state after this long
+    Config<bool> *jsonState = nullptr;     // also publish <base>/State as one JSON message
+
+    void create()
+    {
+        tempDeadband = &ConfigManager.addSettingFloat("PubTDb")
+                            .name("Temperature deadband (°C)")
+                            .category("MQTT Publish")
+                            .defaultValue(0.2f)
+                            .build();
+        timeStepSec = &ConfigManager.addSettingInt("PubTStep")
+                           .name("Time remaining step (s)")
+                           .category("MQTT Publish")
+                           .defaultValue(60)
+                           .build();
+        maxSilenceSec = &ConfigManager.addSettingInt("PubHb")
+                             .name("Max silence / heartbeat (s)")
+                             .category("MQTT Publish")
+                             .defaultValue(300)
+                             .build();
+        jsonState = &ConfigManager.addSettingBool("PubJson")
+                         .name("JSON state topic")
+                         .category("MQTT Publish")
+                         .defaultValue(false)
+                         .build();
+    }
+};
+
+struct ScheduleSettings {
+    Config<bool> *enabled = nullptr;  // pre-heat from the weekly plan
+    Config<String> *plan = nullptr;   // "Mo-Fr 06:30 20:00; Sa,Su 08:00"
+    Config<int> *leadMin = nullptr;   // start heating this long before a planned shower (upper bound when adaptive)
+    Config<bool> *adaptive = nullptr; // lead time from the learned heat-up curve
+    Config<int> *holdMin = nullptr;   // keep the timer running after the planned time
+
+    void create()
+    {
+        enabled = &ConfigManager.addSettingBool("SchEn")
+                       .name("Enable weekly schedule")
+                       .category("Schedule")
+                       .defaultValue(false)
+                       .build();
+        plan = &ConfigManager.addSettingString("SchPlan")
+                    .name("Shower plan (e.g. Mo-Fr 06:30; Sa,Su 08:00)")
+                    .category("Schedule")
+                    .defaultValue(String("Mo-Fr 06:30; Sa,Su 08:00"))
+                    .build();
+        leadMin = &ConfigManager.addSettingInt("SchLead")
+                       .name("Pre-heat lead time (min, max if adaptive)")
+                       .category("Schedule")
+                       .defaultValue(90)
+                       .build();
+        adaptive = &ConfigManager.addSettingBool("SchAdapt")
+                        .name("Adaptive pre-heat start")
+                        .category("Schedule")
+                        .defaultValue(true)
+                        .build();
+        holdMin = &ConfigManager.addSettingInt("SchHold")
+                       .name("Keep warm after planned time (min)")
+                       .category("Schedule")
+                       .defaultValue(30)
+                       .build();
     }
 };
 
@@ -151,6 +303,8 @@ extern DisplaySettings displaySettings;
 extern TempSensorSettings tempSensorSettings;
 extern BoilerSettings boilerSettings;
 extern WiFiUiSettings wifiUiSettings;
+extern PublishSettings publishSettings;
+extern ScheduleSettings scheduleSettings;
 
 // Function to register all settings with ConfigManager
 // This must be called after ConfigManager is properly initialized
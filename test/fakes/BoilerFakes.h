@@ -0,0 +1,79 @@
+#pragma once
+
+// [MOCKED!] Host-side fakes for the boiler control core.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BoilerControl.h"
+
+class FakeRelay : public BoilerRelay
+{
+public:
+    bool get() const override { return on; }
+    void set(bool value) override
+    {
+        if (value != on)
+        {
+            switchCount++;
+        }
+        on = value;
+    }
+
+    bool on = false;
+    uint32_t switchCount = 0;
+};
+
+class FakeClock : public BoilerClock
+{
+public:
+    uint32_t millis() const override { return nowMs; }
+    int64_t epochSeconds() const override { return epoch; }
+
+    void advanceMs(uint32_t ms)
+    {
+        nowMs += ms;
+        if (epoch > 0)
+        {
+            epochCarryMs += ms;
+            epoch += epochCarryMs / 1000;
+            epochCarryMs %= 1000;
+        }
+    }
+
+    uint32_t nowMs = 0;
+    int64_t epoch = 0; // 0 = NTP not synced
+    uint32_t epochCarryMs = 0;
+};
+
+// Records what the firmware would publish / log.
+class FakeMqtt : public BoilerEvents
+{
+public:
+    void onWillShowerCleared() override { published.push_back("WillShower=0"); }
+    void onAlarmChanged(bool active, float) override { published.push_back(active ? "Alarm=1" : "Alarm=0"); }
+    void onForcedHeatingStart(int minutes) override { forcedMinutes = minutes; }
+    void onEarlyStop(float, float) override { published.push_back("EarlyStop"); }
+
+    std::vector<std::string> published;
+    int forcedMinutes = 0;
+};
+
+// Minimal first-order tank: heats while the relay is on, loses heat to ambient otherwise.
+struct FakeTank
+{
+    float temperature = 50.0f;
+    float heatRatePerSec = 0.01f;  // 0.6 K/min burner
+    float lossPerSec = 0.00002f;   // fraction of (T - ambient) per second
+    float ambient = 18.0f;
+
+    void step(bool relayOn, float seconds)
+    {
+        if (relayOn)
+        {
+            temperature += heatRatePerSec * seconds;
+        }
+        temperature -= (temperature - ambient) * lossPerSec * seconds;
+    }
+};
@@ -0,0 +1,470 @@
+#include <unity.h>
+
+#include "BoilerControl.h"
+#include "../fakes/BoilerFakes.h"
+
+static FakeRelay relay;
+static FakeClock clk;
+static FakeMqtt events;
+
+static BoilerController makeController()
+{
+    return BoilerController(relay, clk, events);
+}
+
+// Advance the fake clock by one check interval and run one control step.
+static void stepSecond(BoilerController &ctl, bool forceOn = false)
+{
+    clk.advanceMs(BoilerController::CHECK_INTERVAL_MS);
+    ctl.tick(forceOn);
+}
+
+void setUp()
+{
+    relay = FakeRelay();
+    clk = FakeClock();
+    events = FakeMqtt();
+}
+
+void tearDown() {}
+
+void test_idle_without_timer_keeps_relay_off()
+{
+    BoilerController ctl = makeController();
+    ctl.setTemperature(40.0f);
+    for (int i = 0; i < 10; ++i)
+    {
+        stepSecond(ctl);
+    }
+    TEST_ASSERT_FALSE(relay.on);
+    TEST_ASSERT_EQUAL_INT(0, ctl.timeRemaining());
+}
+
+void test_tick_is_rate_limited_to_one_second()
+{
+    BoilerController ctl = makeController();
+    ctl.setTemperature(40.0f);
+    ctl.startShowerTimer(1);
+    stepSecond(ctl);
+    TEST_ASSERT_EQUAL_INT(59, ctl.timeRemaining());
+
+    clk.advanceMs(500);
+    ctl.tick();
+    TEST_ASSERT_EQUAL_INT(59, ctl.timeRemaining());
+
+    clk.advanceMs(500);
+    ctl.tick();
+    TEST_ASSERT_EQUAL_INT(58, ctl.timeRemaining());
+}
+
+void test_tick_jitter_does_not_stretch_countdown()
+{
+    BoilerController ctl = makeController();
+    ctl.setTemperature(40.0f);
+    ctl.startShowerTimer(1);
+    clk.nowMs = 1000;
+    // Calls alternate 1 ms late / on time, as a scheduler pass may run slightly after its deadline.
+    for (int i = 0; i < 60; ++i)
+    {
+        clk.nowMs = 1000u + 1000u * i + (i % 2);
+        ctl.tick();
+    }
+    TEST_ASSERT_EQUAL_INT(0, ctl.timeRemaining());
+}
+
+void test_timer_expiry_turns_off_and_clears_will_shower()
+{
+    BoilerController ctl = makeController();
+    ctl.setTemperature(40.0f);
+    ctl.setShowerRequest(true);
+    ctl.config().boilerTimeMin = 1;
+    TEST_ASSERT_TRUE(relay.on);
+    TEST_ASSERT_TRUE(ctl.willShowerRequested());
+
+    for (int i = 0; i < 120 * 60 + 1; ++i)
+    {
+        stepSecond(ctl);
+    }
+    TEST_ASSERT_FALSE(relay.on);
+    TEST_ASSERT_TRUE(ctl.lastStopReason() == StopReason::TimerExpired);
+    TEST_ASSERT_FALSE(ctl.willShowerRequested());
+    TEST_ASSERT_EQUAL_INT(1, (int)events.published.size());
+    TEST_ASSERT_EQUAL_STRING("WillShower=0", events.published[0].c_str());
+}
+
+void test_off_threshold_stops_relay_but_timer_keeps_running()
+{
+    BoilerController ctl = makeController();
+    ctl.setTemperature(40.0f);
+    ctl.startShowerTimer(10);
+    stepSecond(ctl);
+    TEST_ASSERT_TRUE(relay.on);
+
+    ctl.setTemperature(80.0f);
+    clk.advanceMs(BoilerController::CHECK_INTERVAL_MS);
+    ctl.tick();
+    // Relay is switched off at target, then the timer branch re-enables it while time remains.
+    TEST_ASSERT_TRUE(ctl.timeRemaining() > 0);
+    TEST_ASSERT_TRUE(ctl.willShowerRequested());
+}
+
+void test_stop_timer_on_target_clears_timer()
+{
+    BoilerController ctl = makeController();
+    ctl.config().stopTimerOnTarget = true;
+    ctl.setTemperature(40.0f);
+    ctl.startShowerTimer(10);
+    stepSecond(ctl);
+
+    ctl.setTemperature(79.0f);
+    stepSecond(ctl);
+    TEST_ASSERT_FALSE(relay.on);
+    TEST_ASSERT_TRUE(ctl.lastStopReason() == StopReason::TargetReached);
+    TEST_ASSERT_EQUAL_INT(0, ctl.timeRemaining());
+    TEST_ASSERT_FALSE(ctl.willShowerRequested());
+}
+
+void test_early_stop_uses_learned_margin()
+{
+    BoilerController ctl = makeController();
+    ctl.setTemperature(40.0f);
+    ctl.startShowerTimer(30);
+    stepSecond(ctl);
+    TEST_ASSERT_TRUE(relay.on);
+
+    // Margin alone does nothing while the feature is off
+    ctl.setStopMargin(2.0f);
+    ctl.setTemperature(76.5f);
+    stepSecond(ctl);
+    TEST_ASSERT_TRUE(relay.on);
+
+    ctl.config().earlyStop = true;
+    ctl.setTemperature(75.5f); // 75.5 + 2.0 < 78
+    stepSecond(ctl);
+    TEST_ASSERT_TRUE(relay.on);
+
+    ctl.setTemperature(76.1f);
+    stepSecond(ctl);
+    TEST_ASSERT_FALSE(relay.on);
+    TEST_ASSERT_EQUAL_INT(0, ctl.timeRemaining());
+    TEST_ASSERT_FALSE(ctl.willShowerRequested());
+    TEST_ASSERT_EQUAL_UINT32(1, ctl.earlyStopCount());
+    TEST_ASSERT_TRUE(ctl.lastStopReason() == StopReason::EarlyStop);
+    TEST_ASSERT_EQUAL_STRING("EarlyStop", events.published.front().c_str());
+
+    stepSecond(ctl);
+    TEST_ASSERT_FALSE(relay.on); // no restart from the timer branch
+}
+
+void test_early_stop_never_overrides_forced_heating()
+{
+    BoilerController ctl = makeController();
+    ctl.config().earlyStop = true;
+    ctl.setStopMargin(50.0f);
+    stepSecond(ctl);
+    ctl.setTemperature(55.0f);
+    ctl.updateAlarm(); // under-temperature -> forced heating on the next step
+    TEST_ASSERT_TRUE(ctl.alarmActive());
+    for (int i = 0; i < 10; ++i)
+    {
+        stepSecond(ctl);
+        TEST_ASSERT_TRUE(relay.on);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ctl.earlyStopCount());
+}
+
+void test_disabled_control_forces_relay_off()
+{
+    BoilerController ctl = makeController();
+    ctl.setTemperature(40.0f);
+    ctl.startShowerTimer(10);
+    ctl.config().enabled = false;
+    stepSecond(ctl);
+    TEST_ASSERT_FALSE(relay.on);
+    TEST_ASSERT_TRUE(ctl.lastStopReason() == StopReason::Disabled);
+}
+
+void test_cancel_shower_request_clears_timer()
+{
+    BoilerController ctl = makeController();
+    ctl.setShowerRequest(true);
+    TEST_ASSERT_EQUAL_INT(120 * 60, ctl.timeRemaining());
+    ctl.setShowerRequest(false);
+    TEST_ASSERT_EQUAL_INT(0, ctl.timeRemaining());
+    TEST_ASSERT_FALSE(relay.on);
+    TEST_ASSERT_TRUE(ctl.lastStopReason() == StopReason::Cancelled);
+}
+
+void test_alarm_hysteresis_and_forced_heating()
+{
+    BoilerController ctl = makeController();
+    stepSecond(ctl);
+    clk.advanceMs(BoilerController::CHECK_INTERVAL_MS / 2); // alarm task between two control steps
+    ctl.setTemperature(55.0f);
+    ctl.updateAlarm();
+    TEST_ASSERT_TRUE(ctl.alarmActive());
+    TEST_ASSERT_FALSE(relay.on);
+    stepSecond(ctl); // latched edge applied by the regular step
+    TEST_ASSERT_EQUAL_INT(120, events.forcedMinutes);
+    TEST_ASSERT_TRUE(relay.on);
+
+    ctl.setTemperature(61.0f); // inside hysteresis band
+    ctl.updateAlarm();
+    TEST_ASSERT_TRUE(ctl.alarmActive());
+
+    ctl.setTemperature(62.0f);
+    ctl.updateAlarm();
+    TEST_ASSERT_FALSE(ctl.alarmActive());
+}
+
+void test_alarm_at_boot_turns_relay_on_before_first_interval()
+{
+    BoilerController ctl = makeController();
+    clk.advanceMs(BoilerController::CHECK_INTERVAL_MS / 2); // first reading during boot
+    ctl.setTemperature(55.0f);
+    ctl.updateAlarm();
+    TEST_ASSERT_TRUE(ctl.alarmActive());
+    TEST_ASSERT_TRUE(relay.on);
+
+    clk.advanceMs(BoilerController::CHECK_INTERVAL_MS / 2);
+    const int remaining = ctl.timeRemaining();
+    ctl.tick(); // the boot step anchors the regular cadence
+    TEST_ASSERT_EQUAL_INT(remaining, ctl.timeRemaining());
+}
+
+void test_period_id_uses_uptime_until_ntp_sync()
+{
+    BoilerController ctl = makeController();
+    ctl.config().boilerTimeMin = 60;
+    clk.nowMs = 2u * 3600u * 1000u + 5u;
+    TEST_ASSERT_EQUAL_INT32(2, ctl.currentPeriodId());
+
+    clk.epoch = 1700000000;
+    TEST_ASSERT_EQUAL_INT32(1700000000L / 3600L, ctl.currentPeriodId());
+}
+
+void test_shower_notice_once_per_period()
+{
+    BoilerController ctl = makeController();
+    clk.epoch = 1700000000;
+    ctl.config().boilerTimeMin = 60;
+    ctl.setTemperature(80.0f);
+    relay.on = true;
+
+    BoilerController::ShowerNotice n = ctl.evaluateShowerNotice(false);
+    TEST_ASSERT_TRUE(n.publish);
+    TEST_ASSERT_TRUE(n.value);
+    TEST_ASSERT_TRUE(n.retained);
+
+    n = ctl.evaluateShowerNotice(false);
+    TEST_ASSERT_FALSE(n.publish);
+
+    relay.on = false;
+    n = ctl.evaluateShowerNotice(false);
+    TEST_ASSERT_TRUE(n.publish);
+    TEST_ASSERT_FALSE(n.value);
+
+    n = ctl.evaluateShowerNotice(false);
+    TEST_ASSERT_FALSE(n.publish);
+}
+
+void test_shower_notice_every_cycle_when_not_gated()
+{
+    BoilerController ctl = makeController();
+    ctl.config().onlyOncePerPeriod = false;
+    ctl.setTemperature(40.0f);
+    for (int i = 0; i < 3; ++i)
+    {
+        BoilerController::ShowerNotice n = ctl.evaluateShowerNotice(false);
+        TEST_ASSERT_TRUE(n.publish);
+        TEST_ASSERT_FALSE(n.value);
+        TEST_ASSERT_FALSE(n.retained);
+    }
+}
+
+void test_min_on_dwell_defers_target_stop()
+{
+    BoilerController ctl = makeController();
+    ctl.config().minOnSec = 60;
+    ctl.config().stopTimerOnTarget = true;
+    ctl.setTemperature(40.0f);
+    ctl.startShowerTimer(10);
+    TEST_ASSERT_TRUE(relay.on);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        stepSecond(ctl);
+    }
+    ctl.setTemperature(79.0f); // noisy spike right after the start
+    for (int i = 0; i < 49; ++i)
+    {
+        stepSecond(ctl);
+        TEST_ASSERT_TRUE(relay.on);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, ctl.deferredCount());
+    stepSecond(ctl);
+    TEST_ASSERT_FALSE(relay.on);
+    TEST_ASSERT_TRUE(ctl.lastStopReason() == StopReason::TargetReached);
+    TEST_ASSERT_EQUAL_UINT32(60, ctl.onTimeSec());
+    TEST_ASSERT_EQUAL_UINT32(2, ctl.switchCount());
+}
+
+void test_min_off_dwell_and_start_budget()
+{
+    BoilerController ctl = makeController();
+    ctl.config().minOnSec = 60;
+    ctl.config().minOffSec = 120;
+    ctl.config().maxStartsPerHour = 2;
+    ctl.setTemperature(40.0f);
+
+    ctl.startShowerTimer(10);
+    TEST_ASSERT_TRUE(relay.on);
+    stepSecond(ctl);
+    ctl.setShowerRequest(false); // user cancel is never held back
+    TEST_ASSERT_FALSE(relay.on);
+
+    ctl.startShowerTimer(10);
+    TEST_ASSERT_FALSE(relay.on); // off dwell
+    for (int i = 0; i < 119; ++i)
+    {
+        stepSecond(ctl);
+    }
+    TEST_ASSERT_FALSE(relay.on);
+    stepSecond(ctl);
+    TEST_ASSERT_TRUE(relay.on);
+    TEST_ASSERT_EQUAL_UINT8(2, ctl.startsLastHour());
+
+    for (int i = 0; i < 60; ++i)
+    {
+        stepSecond(ctl);
+    }
+    ctl.setShowerRequest(false);
+    ctl.startShowerTimer(60);
+    for (int i = 0; i < 600; ++i)
+    {
+        stepSecond(ctl);
+    }
+    TEST_ASSERT_FALSE(relay.on); // budget of two starts per hour used up
+
+    // First start leaves the sliding hour at t = 3600 s
+    while (clk.nowMs + BoilerController::CHECK_INTERVAL_MS < 3600u * 1000u)
+    {
+        stepSecond(ctl);
+        TEST_ASSERT_FALSE(relay.on);
+    }
+    stepSecond(ctl);
+    TEST_ASSERT_TRUE(relay.on);
+    TEST_ASSERT_EQUAL_UINT32(3, ctl.startCount());
+    TEST_ASSERT_EQUAL_UINT32(5, ctl.switchCount());
+    TEST_ASSERT_EQUAL_UINT32(1 + 60, ctl.onTimeSec());
+    TEST_ASSERT_EQUAL_UINT32(2, ctl.deferredCount());
+}
+
+void test_min_on_dwell_overshoot_is_capped()
+{
+    BoilerController ctl = makeController();
+    ctl.config().minOnSec = 600;
+    ctl.config().stopTimerOnTarget = true;
+    ctl.setTemperature(70.0f);
+    ctl.startShowerTimer(30);
+    stepSecond(ctl);
+    ctl.setTemperature(79.0f);
+    stepSecond(ctl);
+    TEST_ASSERT_TRUE(relay.on); // dwell holds it within the margin
+    ctl.setTemperature(78.0f + BoilerController::MAX_DWELL_OVERSHOOT_C);
+    stepSecond(ctl);
+    TEST_ASSERT_FALSE(relay.on);
+    TEST_ASSERT_TRUE(ctl.lastStopReason() == StopReason::TargetReached);
+}
+
+void test_alarm_start_ignores_start_budget()
+{
+    BoilerController ctl = makeController();
+    ctl.config().maxStartsPerHour = 1;
+    ctl.setTemperature(70.0f);
+    ctl.startShowerTimer(1);
+    TEST_ASSERT_TRUE(relay.on);
+    for (int i = 0; i < 61; ++i)
+    {
+        stepSecond(ctl);
+    }
+    TEST_ASSERT_FALSE(relay.on); // timer ran out, budget used up
+
+    clk.advanceMs(BoilerController::CHECK_INTERVAL_MS);
+    ctl.setTemperature(55.0f);
+    ctl.updateAlarm();
+    TEST_ASSERT_TRUE(ctl.alarmActive());
+    TEST_ASSERT_TRUE(relay.on);
+    TEST_ASSERT_EQUAL_UINT32(2, ctl.startCount());
+}
+
+// Simulate 5000 hours of daily showers against a simple tank model.
+void test_long_running_heating_cycles()
+{
+    BoilerController ctl = makeController();
+    ctl.config().stopTimerOnTarget = true;
+    FakeTank tank;
+    uint32_t sessions = 0;
+    uint32_t maxRelayOnStreakSec = 0;
+    uint32_t relayOnStreakSec = 0;
+
+    const uint32_t simulatedHours = 5000;
+    for (uint32_t sec = 0; sec < simulatedHours * 3600u; ++sec)
+    {
+        if (sec % (24u * 3600u) == 6u * 3600u)
+        {
+            ctl.setShowerRequest(true);
+            sessions++;
+        }
+        if (sec % (24u * 3600u) == 7u * 3600u)
+        {
+            tank.temperature -= 25.0f; // shower drains the tank
+        }
+
+        ctl.setTemperature(tank.temperature);
+        if (sec % 2u == 0u)
+        {
+            ctl.updateAlarm();
+        }
+        stepSecond(ctl);
+        tank.step(relay.on, 1.0f);
+
+        relayOnStreakSec = relay.on ? relayOnStreakSec + 1 : 0;
+        if (relayOnStreakSec > maxRelayOnStreakSec)
+        {
+            maxRelayOnStreakSec = relayOnStreakSec;
+        }
+        TEST_ASSERT_TRUE(ctl.timeRemaining() >= 0);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(simulatedHours / 24u + 1u, sessions);
+    // The relay never runs longer than one full timer period.
+    TEST_ASSERT_TRUE(maxRelayOnStreakSec <= (uint32_t)ctl.config().boilerTimeMin * 60u + 1u);
+    TEST_ASSERT_TRUE(tank.temperature < ctl.config().offThreshold + 2.0f);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_without_timer_keeps_relay_off);
+    RUN_TEST(test_tick_is_rate_limited_to_one_second);
+    RUN_TEST(test_tick_jitter_does_not_stretch_countdown);
+    RUN_TEST(test_timer_expiry_turns_off_and_clears_will_shower);
+    RUN_TEST(test_off_threshold_stops_relay_but_timer_keeps_running);
+    RUN_TEST(test_stop_timer_on_target_clears_timer);
+    RUN_TEST(test_early_stop_uses_learned_margin);
+    RUN_TEST(test_early_stop_never_overrides_forced_heating);
+    RUN_TEST(test_disabled_control_forces_relay_off);
+    RUN_TEST(test_cancel_shower_request_clears_timer);
+    RUN_TEST(test_alarm_hysteresis_and_forced_heating);
+    RUN_TEST(test_alarm_at_boot_turns_relay_on_before_first_interval);
+    RUN_TEST(test_period_id_uses_uptime_until_ntp_sync);
+    RUN_TEST(test_shower_notice_once_per_period);
+    RUN_TEST(test_shower_notice_every_cycle_when_not_gated);
+    RUN_TEST(test_min_on_dwell_defers_target_stop);
+    RUN_TEST(test_min_off_dwell_and_start_budget);
+    RUN_TEST(test_min_on_dwell_overshoot_is_capped);
+    RUN_TEST(test_alarm_start_ignores_start_budget);
+    RUN_TEST(test_long_running_heating_cycles);
+    return UNITY_END();
+}
@@ -0,0 +1,73 @@
+#include <unity.h>
+
+#include <cstring>
+
+#include "BootTimeline.h"
+
+namespace
+{
+    const char *const NAMES[] = {"settings", "sensor", "network"};
+    BootTimeline timeline(NAMES, 3);
+}
+
+void setUp()
+{
+    timeline = BootTimeline(NAMES, 3);
+}
+void tearDown() {}
+
+void test_records_durations_and_offsets()
+{
+    timeline.start(0, 100);
+    timeline.finish(0, 140);
+    timeline.start(1, 140);
+    timeline.finish(1, 330);
+    TEST_ASSERT_EQUAL_UINT32(40, timeline.durationMs(0));
+    TEST_ASSERT_EQUAL_UINT32(190, timeline.durationMs(1));
+    TEST_ASSERT_EQUAL_UINT32(330, timeline.doneAtMs(1));
+    TEST_ASSERT_FALSE(timeline.complete());
+}
+
+void test_unfinished_stage_reports_zero_and_dash()
+{
+    timeline.start(0, 0);
+    timeline.finish(0, 12);
+    timeline.start(1, 20);
+    TEST_ASSERT_TRUE(timeline.started(1));
+    TEST_ASSERT_EQUAL_UINT32(0, timeline.durationMs(1));
+    char buf[64];
+    timeline.format(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("settings 12 | sensor - | network -", buf);
+}
+
+void test_complete_and_gaps_between_stages()
+{
+    timeline.finish(0, 50); // finish without start counts as zero length
+    timeline.start(1, 60);
+    timeline.finish(1, 260);
+    timeline.start(2, 900); // lazy stage: loop passes ran in between
+    timeline.finish(2, 1400);
+    TEST_ASSERT_EQUAL_UINT32(0, timeline.durationMs(0));
+    TEST_ASSERT_EQUAL_UINT32(500, timeline.durationMs(2));
+    TEST_ASSERT_TRUE(timeline.complete());
+}
+
+void test_format_truncates_safely()
+{
+    timeline.finish(0, 1);
+    timeline.finish(1, 2);
+    timeline.finish(2, 3);
+    char buf[12];
+    timeline.format(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(buf) - 1, strlen(buf));
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_records_durations_and_offsets);
+    RUN_TEST(test_unfinished_stage_reports_zero_and_dash);
+    RUN_TEST(test_complete_and_gaps_between_stages);
+    RUN_TEST(test_format_truncates_safely);
+    return UNITY_END();
+}
@@ -0,0 +1,117 @@
+#include <unity.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "CommandQueue.h"
+
+namespace
+{
+    struct Command
+    {
+        uint8_t producer;
+        uint32_t seq;
+    };
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_fifo_order_and_empty()
+{
+    CommandQueue<Command, 4> q;
+    Command c = {};
+    TEST_ASSERT_FALSE(q.pop(c));
+    TEST_ASSERT_TRUE(q.push({0, 1}));
+    TEST_ASSERT_TRUE(q.push({0, 2}));
+    TEST_ASSERT_EQUAL(2, q.size());
+    TEST_ASSERT_TRUE(q.pop(c));
+    TEST_ASSERT_EQUAL_UINT32(1, c.seq);
+    TEST_ASSERT_TRUE(q.pop(c));
+    TEST_ASSERT_EQUAL_UINT32(2, c.seq);
+    TEST_ASSERT_FALSE(q.pop(c));
+}
+
+void test_full_queue_drops_and_recovers()
+{
+    CommandQueue<Command, 4> q;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        TEST_ASSERT_TRUE(q.push({0, i}));
+    }
+    TEST_ASSERT_FALSE(q.push({0, 99}));
+    TEST_ASSERT_EQUAL_UINT32(1, q.droppedCount());
+    TEST_ASSERT_EQUAL_UINT32(4, q.highWater());
+
+    Command c = {};
+    TEST_ASSERT_TRUE(q.pop(c));
+    TEST_ASSERT_EQUAL_UINT32(0, c.seq);
+    TEST_ASSERT_TRUE(q.push({0, 4})); // wraps around
+    for (uint32_t i = 1; i <= 4; ++i)
+    {
+        TEST_ASSERT_TRUE(q.pop(c));
+        TEST_ASSERT_EQUAL_UINT32(i, c.seq);
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, q.pushedCount());
+}
+
+void test_multiple_producers_single_consumer()
+{
+    CommandQueue<Command, 16> q;
+    constexpr uint8_t PRODUCERS = 3;
+    constexpr uint32_t PER_PRODUCER = 50000;
+    std::atomic<uint8_t> finished{0};
+
+    std::vector<std::thread> producers;
+    for (uint8_t p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&q, &finished, p]()
+                               {
+            for (uint32_t i = 1; i <= PER_PRODUCER; ++i)
+            {
+                while (!q.push({p, i}))
+                {
+                    std::this_thread::yield(); // back-pressure: retry until the consumer catches up
+                }
+            }
+            finished++; });
+    }
+
+    uint32_t last[PRODUCERS] = {};
+    uint32_t outOfOrder = 0;
+    uint32_t received = 0;
+    Command c = {};
+    while (finished < PRODUCERS || q.size() > 0)
+    {
+        if (q.pop(c))
+        {
+            outOfOrder += c.seq != last[c.producer] + 1 ? 1 : 0;
+            last[c.producer] = c.seq;
+            received++;
+        }
+    }
+    for (std::thread &t : producers)
+    {
+        t.join();
+    }
+    while (q.pop(c))
+    {
+        outOfOrder += c.seq != last[c.producer] + 1 ? 1 : 0;
+        last[c.producer] = c.seq;
+        received++;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, outOfOrder); // per-producer FIFO, nothing lost or duplicated
+    TEST_ASSERT_EQUAL_UINT32(PRODUCERS * PER_PRODUCER, received);
+    TEST_ASSERT_TRUE(q.highWater() <= 16);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo_order_and_empty);
+    RUN_TEST(test_full_queue_drops_and_recovers);
+    RUN_TEST(test_multiple_producers_single_consumer);
+    return UNITY_END();
+}
@@ -0,0 +1,69 @@
+#include <unity.h>
+
+#include "DeltaTracker.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_first_update_marks_all_fields()
+{
+    DeltaTracker t(3, 1000);
+    const int32_t v[3] = {1, 2, 3};
+    TEST_ASSERT_EQUAL_HEX32(0x7, t.update(v));
+    TEST_ASSERT_EQUAL_HEX32(0x7, t.takeDue(0));
+    TEST_ASSERT_EQUAL_HEX32(0, t.update(v));
+    TEST_ASSERT_EQUAL_HEX32(0, t.pending());
+}
+
+void test_only_changed_fields_are_sent()
+{
+    DeltaTracker t(3, 1000);
+    int32_t v[3] = {1, 2, 3};
+    t.update(v);
+    t.takeDue(0);
+    v[1] = 20;
+    TEST_ASSERT_EQUAL_HEX32(0x2, t.update(v));
+    TEST_ASSERT_EQUAL_HEX32(0x2, t.takeDue(1000));
+    TEST_ASSERT_EQUAL_INT32(20, t.value(1));
+}
+
+void test_rate_limit_coalesces_bursts()
+{
+    DeltaTracker t(2, 1000);
+    int32_t v[2] = {0, 0};
+    t.update(v);
+    TEST_ASSERT_EQUAL_HEX32(0x3, t.takeDue(5000));
+
+    for (int32_t i = 1; i <= 10; ++i)
+    {
+        v[0] = i;
+        t.update(v);
+        TEST_ASSERT_EQUAL_HEX32(0, t.takeDue(5000 + static_cast<uint32_t>(i) * 50)); // inside the window
+    }
+    TEST_ASSERT_EQUAL_UINT32(9, t.changesCoalesced());
+    TEST_ASSERT_EQUAL_UINT32(6000, t.nextDueMs(5600));
+    TEST_ASSERT_EQUAL_HEX32(0x1, t.takeDue(6000));
+    TEST_ASSERT_EQUAL_INT32(10, t.value(0));
+    TEST_ASSERT_EQUAL_UINT32(2, t.deltasTaken());
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, t.nextDueMs(6000));
+}
+
+void test_invalidate_resends_everything()
+{
+    DeltaTracker t(32, 0);
+    int32_t v[32] = {};
+    t.update(v);
+    t.takeDue(0);
+    t.invalidate();
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, t.takeDue(1));
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_update_marks_all_fields);
+    RUN_TEST(test_only_changed_fields_are_sent);
+    RUN_TEST(test_rate_limit_coalesces_bursts);
+    RUN_TEST(test_invalidate_resends_everything);
+    return UNITY_END();
+}
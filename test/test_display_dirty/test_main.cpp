@@ -0,0 +1,108 @@
+#include <unity.h>
+
+#include <cstring>
+
+#include "DisplayDirty.h"
+
+namespace
+{
+    uint8_t frame[DisplayDirtyTracker::FRAME_BYTES];
+
+    void setPixel(int x, int y)
+    {
+        frame[x + (y / 8) * DisplayDirtyTracker::WIDTH] |= static_cast<uint8_t>(1U << (y & 7));
+    }
+}
+
+void setUp()
+{
+    memset(frame, 0, sizeof(frame));
+}
+void tearDown() {}
+
+void test_mark_rect_maps_rows_to_pages()
+{
+    DisplayDirtyTracker t;
+    TEST_ASSERT_FALSE(t.dirty());
+    t.markRect(3, 13, 12, 8); // rows 13..20 -> pages 1 and 2
+    TEST_ASSERT_TRUE(t.dirty());
+
+    uint8_t first = 0;
+    uint8_t last = 0;
+    TEST_ASSERT_FALSE(t.span(0, first, last));
+    TEST_ASSERT_TRUE(t.span(1, first, last));
+    TEST_ASSERT_EQUAL_UINT8(3, first);
+    TEST_ASSERT_EQUAL_UINT8(14, last);
+    TEST_ASSERT_TRUE(t.span(2, first, last));
+    TEST_ASSERT_FALSE(t.span(3, first, last));
+}
+
+void test_mark_rect_clips_to_frame()
+{
+    DisplayDirtyTracker t;
+    t.markRect(120, 28, 50, 50);
+    uint8_t first = 0;
+    uint8_t last = 0;
+    TEST_ASSERT_TRUE(t.span(3, first, last));
+    TEST_ASSERT_EQUAL_UINT8(120, first);
+    TEST_ASSERT_EQUAL_UINT8(127, last);
+
+    DisplayDirtyTracker outside;
+    outside.markRect(-10, -10, 5, 5);
+    outside.markRect(0, 0, 0, 8);
+    TEST_ASSERT_FALSE(outside.dirty());
+}
+
+void test_commit_narrows_to_changed_columns()
+{
+    DisplayDirtyTracker t;
+    t.syncAll(frame);
+    setPixel(10, 3);
+    setPixel(12, 4);
+    t.markRect(3, 3, 48, 8); // whole glyph box of the field, pages 0 and 1
+
+    TEST_ASSERT_EQUAL_UINT32(3, t.commit(frame));
+    uint8_t first = 0;
+    uint8_t last = 0;
+    TEST_ASSERT_TRUE(t.span(0, first, last));
+    TEST_ASSERT_EQUAL_UINT8(10, first);
+    TEST_ASSERT_EQUAL_UINT8(12, last);
+    TEST_ASSERT_FALSE(t.span(1, first, last)); // redrawn but identical
+    TEST_ASSERT_EQUAL_UINT32(DisplayDirtyTracker::FRAME_BYTES - 3, t.bytesSaved());
+}
+
+void test_commit_without_pixel_change_sends_nothing()
+{
+    DisplayDirtyTracker t;
+    setPixel(5, 5);
+    t.syncAll(frame);
+    t.markAll();
+    TEST_ASSERT_EQUAL_UINT32(0, t.commit(frame));
+    TEST_ASSERT_FALSE(t.dirty());
+    TEST_ASSERT_EQUAL_UINT32(1, t.flushCount()); // only the syncAll
+}
+
+void test_shadow_follows_committed_bytes()
+{
+    DisplayDirtyTracker t;
+    t.syncAll(frame);
+    setPixel(40, 10);
+    t.markRect(40, 8, 1, 8);
+    TEST_ASSERT_EQUAL_UINT32(1, t.commit(frame));
+    t.clear();
+
+    t.markRect(40, 8, 1, 8);
+    TEST_ASSERT_EQUAL_UINT32(0, t.commit(frame));
+    TEST_ASSERT_EQUAL_UINT32(DisplayDirtyTracker::FRAME_BYTES + 1, t.bytesSent());
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_mark_rect_maps_rows_to_pages);
+    RUN_TEST(test_mark_rect_clips_to_frame);
+    RUN_TEST(test_commit_narrows_to_changed_columns);
+    RUN_TEST(test_commit_without_pixel_change_sends_nothing);
+    RUN_TEST(test_shadow_follows_committed_bytes);
+    return UNITY_END();
+}
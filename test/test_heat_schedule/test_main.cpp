@@ -0,0 +1,106 @@
+#include <unity.h>
+
+#include "HeatSchedule.h"
+
+namespace
+{
+    HeatSchedule schedule;
+
+    uint16_t at(int day, int hour, int minute) // day 0 = Monday
+    {
+        return static_cast<uint16_t>(day * HeatSchedule::MINUTES_PER_DAY + hour * 60 + minute);
+    }
+}
+
+void setUp()
+{
+    schedule.clear();
+}
+void tearDown() {}
+
+void test_compiles_ranges_lists_and_sorts()
+{
+    TEST_ASSERT_TRUE(schedule.compile("Sa,Su 08:00; Mo-Fr 06:30 20:00"));
+    TEST_ASSERT_EQUAL_UINT8(12, schedule.count());
+    TEST_ASSERT_EQUAL_UINT16(at(0, 6, 30), schedule.target(0));
+    TEST_ASSERT_EQUAL_UINT16(at(0, 20, 0), schedule.target(1));
+    TEST_ASSERT_EQUAL_UINT16(at(5, 8, 0), schedule.target(10));
+    TEST_ASSERT_EQUAL_UINT16(at(6, 8, 0), schedule.target(11));
+    for (uint8_t i = 1; i < schedule.count(); ++i)
+    {
+        TEST_ASSERT_TRUE(schedule.target(i - 1) < schedule.target(i));
+    }
+}
+
+void test_wildcard_wrapping_range_and_duplicates()
+{
+    TEST_ASSERT_TRUE(schedule.compile("* 7:05; fr-MO 7:05 22:00"));
+    TEST_ASSERT_EQUAL_UINT8(7 + 4, schedule.count()); // Fr,Sa,Su,Mo 22:00 added, 7:05 collapses
+}
+
+void test_next_lookup_and_week_wrap()
+{
+    TEST_ASSERT_TRUE(schedule.compile("Mo-Fr 06:30; Su 21:15"));
+
+    HeatSchedule::Next n = schedule.next(at(0, 6, 0));
+    TEST_ASSERT_EQUAL_UINT16(at(0, 6, 30), n.minuteOfWeek);
+    TEST_ASSERT_EQUAL_UINT16(30, n.minutesUntil);
+
+    n = schedule.next(at(0, 6, 30));
+    TEST_ASSERT_EQUAL_UINT16(0, n.minutesUntil);
+
+    n = schedule.next(at(0, 6, 31)); // same hour, later minute -> Tuesday
+    TEST_ASSERT_EQUAL_UINT16(at(1, 6, 30), n.minuteOfWeek);
+
+    n = schedule.next(at(6, 21, 16)); // after the last target of the week
+    TEST_ASSERT_EQUAL_UINT8(0, n.index);
+    TEST_ASSERT_EQUAL_UINT16(2 * 60 + 44 + 6 * 60 + 30, n.minutesUntil);
+}
+
+void test_next_matches_linear_scan_for_every_minute()
+{
+    TEST_ASSERT_TRUE(schedule.compile("Mo 00:00 00:59 01:00; We 12:34; Su 23:59"));
+    for (uint16_t m = 0; m < HeatSchedule::MINUTES_PER_WEEK; ++m)
+    {
+        uint16_t best = 0xFFFF;
+        for (uint8_t i = 0; i < schedule.count(); ++i)
+        {
+            const uint16_t d = static_cast<uint16_t>((schedule.target(i) + HeatSchedule::MINUTES_PER_WEEK - m) % HeatSchedule::MINUTES_PER_WEEK);
+            best = d < best ? d : best;
+        }
+        TEST_ASSERT_EQUAL_UINT16(best, schedule.next(m).minutesUntil);
+    }
+}
+
+void test_syntax_errors_keep_previous_table()
+{
+    TEST_ASSERT_TRUE(schedule.compile("Mo 06:00"));
+    TEST_ASSERT_FALSE(schedule.compile("Mo 06:00; Xy 07:00"));
+    TEST_ASSERT_EQUAL_INT(10, schedule.errorOffset());
+    TEST_ASSERT_FALSE(schedule.compile("Mo 25:00"));
+    TEST_ASSERT_FALSE(schedule.compile("Mo"));
+    TEST_ASSERT_FALSE(schedule.compile("Mo 6:5"));
+    TEST_ASSERT_EQUAL_UINT8(1, schedule.count());
+
+    TEST_ASSERT_TRUE(schedule.compile("  ;  "));
+    TEST_ASSERT_EQUAL_UINT8(0, schedule.count());
+    TEST_ASSERT_EQUAL_UINT8(HeatSchedule::NONE, schedule.next(100).index);
+}
+
+void test_minute_of_week_from_tm_fields()
+{
+    TEST_ASSERT_EQUAL_UINT16(at(0, 6, 30), HeatSchedule::minuteOfWeek(1, 6, 30));  // Monday
+    TEST_ASSERT_EQUAL_UINT16(at(6, 23, 59), HeatSchedule::minuteOfWeek(0, 23, 59)); // Sunday
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_compiles_ranges_lists_and_sorts);
+    RUN_TEST(test_wildcard_wrapping_range_and_duplicates);
+    RUN_TEST(test_next_lookup_and_week_wrap);
+    RUN_TEST(test_next_matches_linear_scan_for_every_minute);
+    RUN_TEST(test_syntax_errors_keep_previous_table);
+    RUN_TEST(test_minute_of_week_from_tm_fields);
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+
+#include "HistoryRing.h"
+
+namespace
+{
+    HistoryRing ring; // 24 KB, keep it off the stack
+    constexpr uint32_t T0 = 1700000000UL;
+}
+
+void setUp()
+{
+    ring.clear();
+}
+void tearDown() {}
+
+void test_roundtrip_within_quantization()
+{
+    TEST_ASSERT_TRUE(ring.append(T0, 55.31f, false));
+    TEST_ASSERT_TRUE(ring.append(T0 + 60, 55.50f, true));
+    TEST_ASSERT_TRUE(ring.append(T0 + 120, 54.0f, true));
+    TEST_ASSERT_FALSE(ring.append(T0 + 120, 54.0f, true)); // not newer
+    TEST_ASSERT_EQUAL_UINT32(3, ring.sampleCount());
+    TEST_ASSERT_EQUAL_UINT32(1, ring.blockCount());
+
+    HistoryRing::Cursor c = ring.seek(0);
+    HistoryRing::Sample s;
+    TEST_ASSERT_TRUE(ring.next(c, s));
+    TEST_ASSERT_EQUAL_UINT32(T0, s.time);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f / 32, 55.31f, s.temperature);
+    TEST_ASSERT_FALSE(s.relay);
+    TEST_ASSERT_TRUE(ring.next(c, s));
+    TEST_ASSERT_TRUE(s.relay);
+    TEST_ASSERT_TRUE(ring.next(c, s));
+    TEST_ASSERT_EQUAL_UINT32(T0 + 120, s.time);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f / 32, 54.0f, s.temperature);
+    TEST_ASSERT_FALSE(ring.next(c, s));
+
+    ring.append(T0 + 180, 53.0f, false); // cursor resumes after new data
+    TEST_ASSERT_TRUE(ring.next(c, s));
+    TEST_ASSERT_EQUAL_UINT32(T0 + 180, s.time);
+}
+
+void test_large_steps_and_gaps_start_new_blocks()
+{
+    ring.append(T0, 20.0f, false);
+    ring.append(T0 + 10, 30.0f, false);  // +10 °C
+    ring.append(T0 + 1000, 30.0f, true); // gap > 255 s
+    TEST_ASSERT_EQUAL_UINT32(3, ring.blockCount());
+
+    HistoryRing::Cursor c = ring.seek(0);
+    HistoryRing::Sample s;
+    int n = 0;
+    while (ring.next(c, s))
+    {
+        n++;
+    }
+    TEST_ASSERT_EQUAL_INT(3, n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, s.temperature);
+}
+
+void test_week_at_one_minute_fits_and_wraps()
+{
+    const uint32_t week = 7UL * 24 * 60;
+    float temp = 60.0f;
+    for (uint32_t i = 0; i < week; ++i)
+    {
+        temp += (i % 120 < 60) ? 0.1f : -0.1f;
+        ring.append(T0 + i * 60, temp, i % 120 < 60);
+    }
+    TEST_ASSERT_EQUAL_UINT32(week, ring.sampleCount());
+    TEST_ASSERT_TRUE(ring.bytesUsed() <= 24 * 1024);
+
+    for (uint32_t i = week; i < week + 3000; ++i)
+    {
+        ring.append(T0 + i * 60, temp, false);
+    }
+    TEST_ASSERT_EQUAL_UINT32(HistoryRing::MAX_BLOCKS, ring.blockCount());
+    TEST_ASSERT_TRUE(ring.oldestTime() > T0);
+
+    // sampleCount stays consistent with what iteration yields
+    HistoryRing::Cursor c = ring.seek(0);
+    HistoryRing::Sample s;
+    uint32_t n = 0;
+    uint32_t last = 0;
+    while (ring.next(c, s))
+    {
+        TEST_ASSERT_TRUE(s.time > last);
+        last = s.time;
+        n++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(ring.sampleCount(), n);
+    TEST_ASSERT_EQUAL_UINT32(ring.newestTime(), last);
+}
+
+void test_seek_and_csv_range()
+{
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ring.append(T0 + i * 60, 50.0f + i * 0.0625f, false);
+    }
+    HistoryRing::Cursor c = ring.seek(T0 + 30 * 60 - 1);
+    char buf[128];
+    const size_t n = ring.writeCsv(c, T0 + 32 * 60, buf, sizeof(buf));
+    const std::string csv(buf, n);
+    TEST_ASSERT_EQUAL_STRING("1700001800,51.88,0\n1700001860,51.94,0\n1700001920,52.00,0\n", csv.c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.writeCsv(c, T0 + 32 * 60, buf, sizeof(buf)));
+}
+
+void test_csv_writes_whole_lines_only()
+{
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        ring.append(T0 + i, 20.0f, true);
+    }
+    HistoryRing::Cursor c = ring.seek(0);
+    char buf[40];
+    size_t total = 0;
+    int chunks = 0;
+    size_t n;
+    while ((n = ring.writeCsv(c, UINT32_MAX, buf, sizeof(buf))) > 0)
+    {
+        TEST_ASSERT_EQUAL_INT('\n', buf[n - 1]);
+        total += n;
+        chunks++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(10 * 19, total); // "1700000000,20.00,1\n"
+    TEST_ASSERT_EQUAL_INT(5, chunks);
+}
+
+void test_copy_blocks_exports_raw_layout()
+{
+    ring.append(T0, 40.0f, true);
+    ring.append(T0 + 10, 40.0625f, false);
+    HistoryRing::Cursor c = ring.seek(0);
+    uint8_t buf[HistoryRing::BLOCK_BYTES * 2];
+    TEST_ASSERT_EQUAL_UINT32(HistoryRing::BLOCK_BYTES, ring.copyBlocks(c, UINT32_MAX, buf, sizeof(buf)));
+
+    uint32_t t0;
+    int16_t temp0;
+    memcpy(&t0, buf, 4);
+    memcpy(&temp0, buf + 4, 2);
+    TEST_ASSERT_EQUAL_UINT32(T0, t0);
+    TEST_ASSERT_EQUAL_INT(640, temp0);
+    TEST_ASSERT_EQUAL_UINT8(1, buf[6]);
+    TEST_ASSERT_EQUAL_UINT8(1, buf[7]);
+    TEST_ASSERT_EQUAL_UINT8(10, buf[8]);
+    TEST_ASSERT_EQUAL_UINT8(2, buf[9]); // dtemp +1 << 1, relay off
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_roundtrip_within_quantization);
+    RUN_TEST(test_large_steps_and_gaps_start_new_blocks);
+    RUN_TEST(test_week_at_one_minute_fits_and_wraps);
+    RUN_TEST(test_seek_and_csv_range);
+    RUN_TEST(test_csv_writes_whole_lines_only);
+    RUN_TEST(test_copy_blocks_exports_raw_layout);
+    return UNITY_END();
+}
@@ -0,0 +1,155 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "BoilerControl.h"
+#include "LoopProfiler.h"
+#include "../fakes/BoilerFakes.h"
+
+static uint32_t fakeCycles = 0;
+static uint32_t fakeCycleSource() { return fakeCycles; }
+
+static uint32_t hostNanos()
+{
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+void setUp() { fakeCycles = 0; }
+void tearDown() {}
+
+void test_bucket_bounds_cover_values()
+{
+    const uint32_t samples[] = {0, 1, 3, 4, 7, 8, 100, 1000, 65535, 1000000, 0xFFFFFFFFu};
+    for (uint32_t v : samples)
+    {
+        const uint8_t idx = LatencyHistogram::bucketIndex(v);
+        TEST_ASSERT_TRUE(idx < LatencyHistogram::BUCKET_COUNT);
+        TEST_ASSERT_TRUE(LatencyHistogram::bucketUpperBound(idx) >= v);
+        // Bucket width stays within 25% of the value
+        TEST_ASSERT_TRUE(LatencyHistogram::bucketUpperBound(idx) - v <= v / 4 + 1);
+    }
+}
+
+void test_percentiles_min_max()
+{
+    LatencyHistogram h;
+    for (uint32_t v = 1; v <= 1000; ++v)
+    {
+        h.record(v);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1000, h.count());
+    TEST_ASSERT_EQUAL_UINT32(1, h.min());
+    TEST_ASSERT_EQUAL_UINT32(1000, h.max());
+    const uint32_t p50 = h.percentile(50.0f);
+    const uint32_t p99 = h.percentile(99.0f);
+    TEST_ASSERT_TRUE(p50 >= 500 && p50 <= 640);
+    TEST_ASSERT_TRUE(p99 >= 990 && p99 <= 1000);
+
+    h.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, h.count());
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentile(50.0f));
+}
+
+void test_scope_records_stage_cycles()
+{
+    LoopProfiler profiler(fakeCycleSource, 240);
+    const uint8_t stage = profiler.addStage("web");
+    {
+        LoopProfiler::Scope scope(profiler, stage);
+        fakeCycles += 2400;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, profiler.histogram(stage).count());
+    TEST_ASSERT_EQUAL_UINT32(2400, profiler.histogram(stage).max());
+    TEST_ASSERT_EQUAL_UINT32(10, profiler.toUs(profiler.histogram(stage).max()));
+}
+
+void test_json_report()
+{
+    LoopProfiler profiler(fakeCycleSource);
+    const uint8_t a = profiler.addStage("a");
+    profiler.addStage("b");
+    profiler.record(a, 7);
+    char buf[256];
+    profiler.writeJson(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"cyclesPerUs\":1,\"stages\":[{\"name\":\"a\",\"n\":1,\"min\":7,\"p50\":7,\"p99\":7,\"max\":7},"
+        "{\"name\":\"b\",\"n\":0,\"min\":0,\"p50\":0,\"p99\":0,\"max\":0}]}",
+        buf);
+
+    char small[16];
+    const size_t n = profiler.writeJson(small, sizeof(small));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(small) - 1, n);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(small) - 1, strlen(small));
+}
+
+void test_slowest_stage_skips_excluded()
+{
+    LoopProfiler profiler(fakeCycleSource);
+    const uint8_t a = profiler.addStage("a");
+    const uint8_t b = profiler.addStage("b");
+    const uint8_t total = profiler.addStage("total");
+    profiler.record(a, 10);
+    profiler.record(b, 50);
+    profiler.record(total, 70);
+    TEST_ASSERT_EQUAL_UINT8(total, profiler.slowestStage());
+    TEST_ASSERT_EQUAL_UINT8(b, profiler.slowestStage(total));
+}
+
+// Host benchmark: run the control core against the fakes and print per-stage timings (ns),
+// so numbers can be compared between commits.
+void test_benchmark_control_core()
+{
+    FakeRelay relay;
+    FakeClock clk;
+    FakeMqtt events;
+    FakeTank tank;
+    BoilerController ctl(relay, clk, events);
+
+    LoopProfiler profiler(hostNanos);
+    const uint8_t stTick = profiler.addStage("boiler.tick");
+    const uint8_t stAlarm = profiler.addStage("boiler.alarm");
+    const uint8_t stNotice = profiler.addStage("boiler.notice");
+
+    for (uint32_t sec = 0; sec < 200000; ++sec)
+    {
+        if (sec % 20000 == 0)
+        {
+            ctl.setShowerRequest(true);
+        }
+        ctl.setTemperature(tank.temperature);
+        clk.advanceMs(1000);
+        {
+            LoopProfiler::Scope scope(profiler, stTick);
+            ctl.tick();
+        }
+        {
+            LoopProfiler::Scope scope(profiler, stAlarm);
+            ctl.updateAlarm();
+        }
+        {
+            LoopProfiler::Scope scope(profiler, stNotice);
+            ctl.evaluateShowerNotice(false);
+        }
+        tank.step(relay.on, 1.0f);
+    }
+
+    char report[512];
+    profiler.writeJson(report, sizeof(report));
+    TEST_MESSAGE(report);
+    TEST_ASSERT_EQUAL_UINT32(200000, profiler.histogram(stTick).count());
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bucket_bounds_cover_values);
+    RUN_TEST(test_percentiles_min_max);
+    RUN_TEST(test_scope_records_stage_cycles);
+    RUN_TEST(test_json_report);
+    RUN_TEST(test_slowest_stage_skips_excluded);
+    RUN_TEST(test_benchmark_control_core);
+    return UNITY_END();
+}
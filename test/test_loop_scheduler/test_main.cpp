@@ -0,0 +1,170 @@
+#include <unity.h>
+
+#include <string>
+
+#include "LoopScheduler.h"
+
+static std::string trace;
+static LoopScheduler *sched = nullptr;
+static uint8_t selfId = 0;
+static uint32_t fakeNow = 0;
+
+static void taskA() { trace += "A"; }
+static void taskB() { trace += "B"; }
+static void taskC() { trace += "C"; }
+static void taskReschedule()
+{
+    trace += "R";
+    sched->scheduleAt(selfId, fakeNow + 7);
+}
+
+void setUp()
+{
+    trace.clear();
+    fakeNow = 0;
+}
+void tearDown() {}
+
+void test_runs_in_deadline_order()
+{
+    LoopScheduler s;
+    const uint8_t a = s.add("a", 100, taskA, 0);
+    const uint8_t b = s.add("b", 100, taskB, 0);
+    s.add("c", 100, taskC, 0);
+    s.scheduleAt(a, 30);
+    s.scheduleAt(b, 10);
+
+    TEST_ASSERT_EQUAL_UINT8(1, s.runDue(0)); // only c is due at t=0
+    TEST_ASSERT_EQUAL_STRING("C", trace.c_str());
+
+    trace.clear();
+    TEST_ASSERT_EQUAL_UINT8(2, s.runDue(40));
+    TEST_ASSERT_EQUAL_STRING("BA", trace.c_str());
+}
+
+void test_ms_until_next_deadline()
+{
+    LoopScheduler s;
+    s.add("a", 50, taskA, 0);
+    s.add("b", 20, taskB, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, s.msUntilNext(0));
+    s.runDue(0);
+    TEST_ASSERT_EQUAL_UINT32(20, s.msUntilNext(0));
+    TEST_ASSERT_EQUAL_UINT32(5, s.msUntilNext(15));
+    TEST_ASSERT_EQUAL_UINT32(0, s.msUntilNext(25));
+}
+
+void test_deadlines_do_not_drift_with_late_runs()
+{
+    LoopScheduler s;
+    const uint8_t a = s.add("a", 1000, taskA, 0);
+    s.runDue(0);
+    s.runDue(1030); // ran 30 ms late
+    TEST_ASSERT_EQUAL_UINT32(970, s.msUntilNext(1030));
+    s.runDue(2001);
+    TEST_ASSERT_EQUAL_UINT32(3, s.runCount(a));
+    TEST_ASSERT_EQUAL_UINT32(999, s.msUntilNext(2001));
+    TEST_ASSERT_EQUAL_UINT32(0, s.lateCount());
+}
+
+void test_missed_periods_resync_without_burst()
+{
+    LoopScheduler s;
+    s.add("a", 100, taskA, 0);
+    s.runDue(0);
+    TEST_ASSERT_EQUAL_UINT8(1, s.runDue(550));
+    TEST_ASSERT_EQUAL_UINT32(1, s.lateCount());
+    TEST_ASSERT_EQUAL_UINT32(100, s.msUntilNext(550));
+}
+
+void test_trigger_runs_early_and_keeps_deadline()
+{
+    LoopScheduler s;
+    const uint8_t a = s.add("a", 100, taskA, 0);
+    s.runDue(0);
+    s.trigger(a);
+    TEST_ASSERT_EQUAL_UINT32(0, s.msUntilNext(10));
+    TEST_ASSERT_EQUAL_UINT8(1, s.runDue(10));
+    TEST_ASSERT_EQUAL_UINT32(90, s.msUntilNext(10));
+}
+
+void test_zero_interval_runs_only_when_scheduled()
+{
+    LoopScheduler s;
+    sched = &s;
+    selfId = s.add("r", 0, taskReschedule, 0);
+    s.runDue(0);
+    TEST_ASSERT_EQUAL_UINT32(7, s.msUntilNext(0));
+    fakeNow = 7;
+    s.runDue(7);
+    TEST_ASSERT_EQUAL_STRING("RR", trace.c_str());
+    TEST_ASSERT_EQUAL_UINT32(7, s.msUntilNext(7));
+    sched = nullptr;
+}
+
+void test_idle_task_never_fires_on_its_own()
+{
+    LoopScheduler s;
+    const uint8_t id = s.add("a", 0, taskA, 0);
+    s.runDue(0);
+    // Well past the point where an "idle" deadline far in the future would come due
+    const uint32_t later = 0x80000000UL;
+    TEST_ASSERT_EQUAL_UINT32(0x7FFFFFFFUL, s.msUntilNext(later));
+    TEST_ASSERT_EQUAL_UINT8(0, s.runDue(later));
+    s.trigger(id);
+    TEST_ASSERT_EQUAL_UINT8(1, s.runDue(later));
+    s.scheduleAt(id, later + 5);
+    TEST_ASSERT_EQUAL_UINT32(5, s.msUntilNext(later));
+    TEST_ASSERT_EQUAL_UINT8(1, s.runDue(later + 5));
+    TEST_ASSERT_EQUAL_STRING("AAA", trace.c_str());
+}
+
+void test_clock_wraparound()
+{
+    LoopScheduler s;
+    const uint32_t start = 0xFFFFFF00u;
+    s.add("a", 0x200, taskA, start);
+    s.runDue(start);
+    TEST_ASSERT_EQUAL_UINT32(0x200, s.msUntilNext(start));
+    TEST_ASSERT_EQUAL_UINT8(0, s.runDue(0x00000050u));
+    TEST_ASSERT_EQUAL_UINT8(1, s.runDue(0x00000100u));
+}
+
+// One simulated day with the firmware's task set: count loop wakeups vs. fixed 10 ms polling.
+void test_wakeups_per_day()
+{
+    LoopScheduler s;
+    s.add("io", 20, taskA, 0);
+    s.add("net", 20, taskA, 0);
+    s.add("display", 100, taskB, 0);
+    s.add("alarm", 1500, taskC, 0);
+    s.add("boiler", 1000, taskC, 0);
+
+    uint32_t now = 0;
+    uint32_t wakeups = 0;
+    while (now < 24u * 3600u * 1000u)
+    {
+        if (s.runDue(now))
+        {
+            wakeups++;
+        }
+        now += s.msUntilNext(now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(24u * 3600u * 1000u / 20u, wakeups);
+    TEST_ASSERT_TRUE(wakeups < 24u * 3600u * 1000u / 10u);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_runs_in_deadline_order);
+    RUN_TEST(test_ms_until_next_deadline);
+    RUN_TEST(test_deadlines_do_not_drift_with_late_runs);
+    RUN_TEST(test_missed_periods_resync_without_burst);
+    RUN_TEST(test_trigger_runs_early_and_keeps_deadline);
+    RUN_TEST(test_zero_interval_runs_only_when_scheduled);
+    RUN_TEST(test_idle_task_never_fires_on_its_own);
+    RUN_TEST(test_clock_wraparound);
+    RUN_TEST(test_wakeups_per_day);
+    return UNITY_END();
+}
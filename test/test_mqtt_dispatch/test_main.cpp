@@ -0,0 +1,167 @@
+#include <unity.h>
+
+#include <cstring>
+
+#include "MqttDispatch.h"
+#include "MqttTopics.h"
+
+namespace
+{
+    MqttValue lastValue;
+    int calls = 0;
+    int otherCalls = 0;
+
+    void capture(const MqttValue &v)
+    {
+        lastValue = v;
+        calls++;
+    }
+
+    void other(const MqttValue &)
+    {
+        otherCalls++;
+    }
+
+    bool send(const MqttDispatcher &d, const char *topic, const char *payload)
+    {
+        return d.dispatch(topic, reinterpret_cast<const uint8_t *>(payload), static_cast<unsigned>(strlen(payload)));
+    }
+}
+
+void setUp()
+{
+    lastValue = MqttValue();
+    calls = 0;
+    otherCalls = 0;
+}
+void tearDown() {}
+
+void test_routes_by_suffix_after_base()
+{
+    MqttTopicTable topics;
+    topics.build("home/boiler");
+    MqttDispatcher d;
+    TEST_ASSERT_TRUE(d.add(MqttTopicTable::suffix(MqttTopic::WillShower), PayloadKind::Bool, capture));
+    TEST_ASSERT_TRUE(d.add(MqttTopicTable::suffix(MqttTopic::Save), PayloadKind::None, other));
+    d.setBase(topics.base());
+
+    TEST_ASSERT_TRUE(send(d, topics.get(MqttTopic::WillShower), " ON\r\n"));
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_TRUE(lastValue.b);
+
+    TEST_ASSERT_TRUE(send(d, "home/boiler/Settings/Save", "x"));
+    TEST_ASSERT_EQUAL_INT(1, otherCalls);
+
+    TEST_ASSERT_FALSE(send(d, "other/Settings/Save", "x"));
+    TEST_ASSERT_FALSE(send(d, "home/boiler/Settings/Sav", "x"));
+    TEST_ASSERT_FALSE(send(d, "home/boiler/Settings/SaveX", "x"));
+    TEST_ASSERT_EQUAL_INT(1, otherCalls);
+}
+
+void test_rebased_table_follows_new_base()
+{
+    MqttTopicTable topics;
+    topics.build("a");
+    MqttDispatcher d;
+    d.add("/Settings/OnThreshold", PayloadKind::Float, capture);
+    d.setBase(topics.base());
+    TEST_ASSERT_TRUE(send(d, "a/Settings/OnThreshold", "40"));
+
+    topics.build("bb/cc");
+    d.setBase(topics.base());
+    TEST_ASSERT_FALSE(send(d, "a/Settings/OnThreshold", "40"));
+    TEST_ASSERT_TRUE(send(d, "bb/cc/Settings/OnThreshold", "41.5"));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 41.5f, lastValue.f);
+
+    d.setBase(nullptr);
+    TEST_ASSERT_FALSE(send(d, "bb/cc/Settings/OnThreshold", "41.5"));
+}
+
+void test_all_topic_suffixes_fit_and_resolve()
+{
+    MqttDispatcher d;
+    for (uint8_t i = 0; i < MqttTopicTable::COUNT; ++i)
+    {
+        TEST_ASSERT_TRUE(d.add(MqttTopicTable::suffix(static_cast<MqttTopic>(i)), PayloadKind::None, other));
+    }
+    TEST_ASSERT_FALSE(d.add(MqttTopicTable::suffix(MqttTopic::Save), PayloadKind::None, other)); // duplicate
+    TEST_ASSERT_EQUAL_UINT8(MqttTopicTable::COUNT, d.size());
+
+    MqttTopicTable topics;
+    topics.build("BoilerSaver");
+    d.setBase(topics.base());
+    for (uint8_t i = 0; i < MqttTopicTable::COUNT; ++i)
+    {
+        TEST_ASSERT_TRUE(send(d, topics.get(static_cast<MqttTopic>(i)), "1"));
+    }
+    TEST_ASSERT_EQUAL_INT(MqttTopicTable::COUNT, otherCalls);
+}
+
+void test_parse_bool()
+{
+    TEST_ASSERT_TRUE(MqttDispatcher::parseBool("1", 1));
+    TEST_ASSERT_TRUE(MqttDispatcher::parseBool("TRUE", 4));
+    TEST_ASSERT_TRUE(MqttDispatcher::parseBool("On", 2));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseBool("0", 1));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseBool("only", 4));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseBool("o", 1));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseBool("", 0));
+}
+
+void test_parse_int()
+{
+    long v = 0;
+    TEST_ASSERT_TRUE(MqttDispatcher::parseInt("45", 2, v));
+    TEST_ASSERT_EQUAL_INT32(45, v);
+    TEST_ASSERT_TRUE(MqttDispatcher::parseInt("-3", 2, v));
+    TEST_ASSERT_EQUAL_INT32(-3, v);
+    TEST_ASSERT_TRUE(MqttDispatcher::parseInt("12.9", 4, v)); // like toInt()
+    TEST_ASSERT_EQUAL_INT32(12, v);
+    TEST_ASSERT_TRUE(MqttDispatcher::parseInt("123", 2, v)); // span, not NUL terminated
+    TEST_ASSERT_EQUAL_INT32(12, v);
+    TEST_ASSERT_FALSE(MqttDispatcher::parseInt("null", 4, v));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseInt("NaN", 3, v));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseInt("-", 1, v));
+}
+
+void test_parse_float()
+{
+    float f = 0;
+    TEST_ASSERT_TRUE(MqttDispatcher::parseFloat("42.25", 5, f));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 42.25f, f);
+    TEST_ASSERT_TRUE(MqttDispatcher::parseFloat("-0.5", 4, f));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.5f, f);
+    TEST_ASSERT_TRUE(MqttDispatcher::parseFloat(".5", 2, f));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.5f, f);
+    TEST_ASSERT_TRUE(MqttDispatcher::parseFloat("4.5e1", 5, f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 45.0f, f);
+    TEST_ASSERT_FALSE(MqttDispatcher::parseFloat("NaN", 3, f));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseFloat("Infinity", 8, f));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseFloat("-Infinity", 9, f));
+    TEST_ASSERT_FALSE(MqttDispatcher::parseFloat("undefined", 9, f));
+}
+
+void test_invalid_payload_still_reaches_handler_flagged()
+{
+    MqttDispatcher d;
+    d.add("/Settings/SetShowerTime", PayloadKind::Int, capture);
+    d.setBase("b");
+    TEST_ASSERT_TRUE(send(d, "b/Settings/SetShowerTime", " null "));
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_FALSE(lastValue.valid);
+    TEST_ASSERT_EQUAL_UINT32(4, lastValue.rawLen);
+    TEST_ASSERT_EQUAL_INT(0, strncmp(lastValue.raw, "null", 4));
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_routes_by_suffix_after_base);
+    RUN_TEST(test_rebased_table_follows_new_base);
+    RUN_TEST(test_all_topic_suffixes_fit_and_resolve);
+    RUN_TEST(test_parse_bool);
+    RUN_TEST(test_parse_int);
+    RUN_TEST(test_parse_float);
+    RUN_TEST(test_invalid_payload_still_reaches_handler_flagged);
+    return UNITY_END();
+}
@@ -0,0 +1,63 @@
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+
+#include "MqttTopics.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_build_composes_all_topics()
+{
+    MqttTopicTable table;
+    TEST_ASSERT_TRUE(table.build("BoilerSaver"));
+    TEST_ASSERT_TRUE(table.ready());
+    TEST_ASSERT_EQUAL_STRING("BoilerSaver", table.base());
+    TEST_ASSERT_EQUAL_STRING("BoilerSaver/ActualState", table.get(MqttTopic::ActualState));
+    TEST_ASSERT_EQUAL_STRING("BoilerSaver/TemperatureBoiler", table.get(MqttTopic::TemperatureBoiler));
+    TEST_ASSERT_EQUAL_STRING("BoilerSaver/Settings/WillShower", table.get(MqttTopic::WillShower));
+    TEST_ASSERT_EQUAL_STRING("BoilerSaver/Settings/YouCanShowerPeriodMin", table.get(MqttTopic::YouCanShowerPeriodMin));
+
+    for (uint8_t i = 0; i < MqttTopicTable::COUNT; ++i)
+    {
+        const std::string expected = std::string("BoilerSaver") + MqttTopicTable::suffix(static_cast<MqttTopic>(i));
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), table.get(static_cast<MqttTopic>(i)));
+    }
+}
+
+void test_has_base_and_rebuild()
+{
+    MqttTopicTable table;
+    TEST_ASSERT_FALSE(table.hasBase("a"));
+    table.build("a");
+    TEST_ASSERT_TRUE(table.hasBase("a"));
+    TEST_ASSERT_FALSE(table.hasBase("b"));
+    table.build("home/boiler");
+    TEST_ASSERT_EQUAL_STRING("home/boiler/Settings/Save", table.get(MqttTopic::Save));
+}
+
+void test_rejects_empty_and_too_long_base()
+{
+    MqttTopicTable table;
+    TEST_ASSERT_FALSE(table.build(""));
+    TEST_ASSERT_FALSE(table.build(nullptr));
+    TEST_ASSERT_EQUAL_STRING("", table.get(MqttTopic::ActualState));
+
+    std::string longest(MqttTopicTable::MAX_BASE_LEN, 'x');
+    TEST_ASSERT_TRUE(table.build(longest.c_str()));
+    TEST_ASSERT_TRUE(table.bytesUsed() <= MqttTopicTable::ARENA_SIZE);
+
+    std::string tooLong(MqttTopicTable::MAX_BASE_LEN + 1, 'x');
+    TEST_ASSERT_FALSE(table.build(tooLong.c_str()));
+    TEST_ASSERT_FALSE(table.ready());
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_build_composes_all_topics);
+    RUN_TEST(test_has_base_and_rebuild);
+    RUN_TEST(test_rejects_empty_and_too_long_base);
+    return UNITY_END();
+}
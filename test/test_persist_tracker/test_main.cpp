@@ -0,0 +1,94 @@
+#include <unity.h>
+
+#include "PersistTracker.h"
+
+namespace
+{
+    constexpr uint32_t DEBOUNCE_MS = 2000;
+    constexpr uint32_t MAX_DELAY_MS = 10000;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_clean_keys_are_not_written()
+{
+    PersistTracker t(4, DEBOUNCE_MS, MAX_DELAY_MS);
+    for (uint8_t k = 0; k < 4; ++k)
+    {
+        t.setStored(k, 100 + k);
+    }
+    t.update(1, 101, 0); // same as stored
+    t.requestFlush(0);
+    TEST_ASSERT_EQUAL_HEX32(0, t.takeDue(DEBOUNCE_MS));
+    TEST_ASSERT_FALSE(t.flushPending());
+    TEST_ASSERT_EQUAL_UINT32(0, t.keyWrites());
+    TEST_ASSERT_EQUAL_UINT32(4, t.writesAvoided());
+}
+
+void test_only_changed_keys_after_debounce()
+{
+    PersistTracker t(4, DEBOUNCE_MS, MAX_DELAY_MS);
+    t.update(2, 7, 100);
+    t.requestFlush(100);
+    TEST_ASSERT_EQUAL_HEX32(0, t.takeDue(1000)); // still inside the window
+    TEST_ASSERT_EQUAL_UINT32(2100, t.nextDueMs(1000));
+    TEST_ASSERT_EQUAL_HEX32(0x4, t.takeDue(2100));
+    TEST_ASSERT_EQUAL_UINT32(1, t.keyWrites());
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, t.nextDueMs(2200));
+}
+
+void test_spam_is_coalesced_and_capped()
+{
+    PersistTracker t(4, DEBOUNCE_MS, MAX_DELAY_MS);
+    uint32_t now = 0;
+    uint32_t flushedAt = 0;
+    for (int i = 1; i <= 100; ++i, now += 500) // new threshold + save twice a second
+    {
+        t.update(0, static_cast<uint32_t>(i), now);
+        t.requestFlush(now);
+        if (t.takeDue(now) != 0 && flushedAt == 0)
+        {
+            flushedAt = now;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(MAX_DELAY_MS, flushedAt); // the window never closes, the cap forces a write
+    TEST_ASSERT_TRUE(t.keyWrites() <= 6);
+    TEST_ASSERT_TRUE(t.writesAvoided() > 300);
+}
+
+void test_value_changed_back_is_not_dirty()
+{
+    PersistTracker t(2, DEBOUNCE_MS, MAX_DELAY_MS);
+    t.setStored(0, 40);
+    t.update(0, 45, 0);
+    TEST_ASSERT_EQUAL_HEX32(0x1, t.dirtyMask());
+    t.update(0, 40, 10);
+    TEST_ASSERT_EQUAL_HEX32(0, t.dirtyMask());
+}
+
+void test_forgotten_key_is_written_even_if_unchanged()
+{
+    PersistTracker t(2, DEBOUNCE_MS, MAX_DELAY_MS);
+    t.setStored(0, 40);
+    t.setStored(1, 7);
+    t.forgetStored(0); // flash written elsewhere, e.g. 45 saved from the web UI
+    t.update(0, 45, 0);
+    t.update(0, 40, 10); // back to the boot value over MQTT
+    t.requestFlush(20);
+    TEST_ASSERT_EQUAL_HEX32(0x1, t.takeDue(20 + DEBOUNCE_MS));
+    t.update(0, 45, 30 + DEBOUNCE_MS);
+    t.update(0, 40, 40 + DEBOUNCE_MS);
+    TEST_ASSERT_EQUAL_HEX32(0, t.dirtyMask()); // known again after the write
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_keys_are_not_written);
+    RUN_TEST(test_only_changed_keys_after_debounce);
+    RUN_TEST(test_spam_is_coalesced_and_capped);
+    RUN_TEST(test_value_changed_back_is_not_dirty);
+    RUN_TEST(test_forgotten_key_is_written_even_if_unchanged);
+    return UNITY_END();
+}
@@ -0,0 +1,72 @@
+#include <unity.h>
+
+#include "PreheatModel.h"
+
+namespace
+{
+    PreheatModel model;
+}
+
+void setUp()
+{
+    model.reset();
+}
+void tearDown() {}
+
+void test_unknown_until_enough_sessions()
+{
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, model.estimateMinutes(50.0f));
+    model.addSession(50.0f, 60.0f);
+    model.addSession(55.0f, 48.0f);
+    TEST_ASSERT_FALSE(model.known());
+    model.addSession(-1.0f, -5.0f); // invalid duration is ignored
+    TEST_ASSERT_FALSE(model.known());
+    model.addSession(60.0f, 36.0f);
+    TEST_ASSERT_TRUE(model.known());
+}
+
+void test_fits_linear_heat_up_curve()
+{
+    // 2.4 min per °C below 75 °C (0.42 °C/min burner)
+    for (float start = 40.0f; start <= 70.0f; start += 5.0f)
+    {
+        model.addSession(start, (75.0f - start) * 2.4f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, -2.4f, model.slope());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 36.0f, model.estimateMinutes(60.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, model.estimateMinutes(80.0f)); // already hot
+}
+
+void test_same_start_temperature_uses_mean_duration()
+{
+    model.addSession(50.0f, 40.0f);
+    model.addSession(50.5f, 50.0f);
+    model.addSession(50.2f, 45.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, model.slope());
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 45.0f, model.estimateMinutes(30.0f));
+}
+
+void test_recent_sessions_dominate()
+{
+    for (int i = 0; i < 30; ++i)
+    {
+        model.addSession(45.0f + (i % 3) * 10.0f, (75.0f - (45.0f + (i % 3) * 10.0f)) * 2.0f); // summer
+    }
+    const float summer = model.estimateMinutes(50.0f);
+    for (int i = 0; i < 30; ++i)
+    {
+        model.addSession(45.0f + (i % 3) * 10.0f, (75.0f - (45.0f + (i % 3) * 10.0f)) * 3.0f); // winter
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 50.0f, summer);
+    TEST_ASSERT_FLOAT_WITHIN(6.0f, 75.0f, model.estimateMinutes(50.0f)); // ~80 % weight on the last 30
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_unknown_until_enough_sessions);
+    RUN_TEST(test_fits_linear_heat_up_curve);
+    RUN_TEST(test_same_start_temperature_uses_mean_duration);
+    RUN_TEST(test_recent_sessions_dominate);
+    return UNITY_END();
+}
@@ -0,0 +1,85 @@
+#include <unity.h>
+
+#include "PublishCache.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_first_value_is_always_due()
+{
+    PublishCache cache;
+    cache.configure(0, 0.2f, 0);
+    TEST_ASSERT_TRUE(cache.offer(0, 55.0f, 0));
+    TEST_ASSERT_FALSE(cache.offer(0, 55.0f, 10));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.sentCount());
+    TEST_ASSERT_EQUAL_UINT32(1, cache.suppressedCount());
+}
+
+void test_deadband_is_measured_from_last_published_value()
+{
+    PublishCache cache;
+    cache.configure(0, 0.2f, 0);
+    cache.offer(0, 55.0f, 0);
+    TEST_ASSERT_FALSE(cache.offer(0, 55.1f, 1));
+    TEST_ASSERT_FALSE(cache.offer(0, 55.15f, 2)); // slow drift does not reset the reference
+    TEST_ASSERT_TRUE(cache.offer(0, 55.25f, 3));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 55.25f, cache.lastValue(0));
+    TEST_ASSERT_TRUE(cache.offer(0, 55.0f, 4));
+}
+
+void test_zero_deadband_publishes_any_change()
+{
+    PublishCache cache;
+    cache.configure(1, 0.0f, 0);
+    cache.offer(1, 0.0f, 0);
+    TEST_ASSERT_FALSE(cache.offer(1, 0.0f, 1));
+    TEST_ASSERT_TRUE(cache.offer(1, 1.0f, 2));
+    TEST_ASSERT_TRUE(cache.offer(1, 0.0f, 3));
+}
+
+void test_transition_to_zero_bypasses_deadband()
+{
+    PublishCache cache;
+    cache.configure(0, 60.0f, 0); // time remaining, minute steps
+    cache.offer(0, 3600.0f, 0);
+    TEST_ASSERT_FALSE(cache.offer(0, 3590.0f, 10));
+    TEST_ASSERT_TRUE(cache.offer(0, 3540.0f, 60));
+    TEST_ASSERT_TRUE(cache.offer(0, 30.0f, 3570));
+    TEST_ASSERT_FALSE(cache.offer(0, 10.0f, 3590));
+    TEST_ASSERT_TRUE(cache.offer(0, 0.0f, 3600)); // timer ran out: less than one step, still published
+}
+
+void test_heartbeat_after_max_silence()
+{
+    PublishCache cache;
+    cache.configure(0, 1.0f, 0);
+    cache.setMaxSilence(1000);
+    cache.offer(0, 20.0f, 0);
+    TEST_ASSERT_FALSE(cache.offer(0, 20.0f, 999));
+    TEST_ASSERT_TRUE(cache.offer(0, 20.0f, 1000));
+    TEST_ASSERT_FALSE(cache.offer(0, 20.0f, 1500));
+    TEST_ASSERT_TRUE(cache.offer(0, 20.0f, 0xFFFFFFF0UL)); // wrap-safe elapsed time
+}
+
+void test_invalidate_forces_republish()
+{
+    PublishCache cache;
+    cache.offer(0, 1.0f, 0);
+    cache.offer(1, 2.0f, 0);
+    cache.invalidate();
+    TEST_ASSERT_TRUE(cache.due(0, 1.0f, 1));
+    TEST_ASSERT_TRUE(cache.due(1, 2.0f, 1));
+    TEST_ASSERT_FALSE(cache.due(PublishCache::MAX_SLOTS, 1.0f, 1));
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_value_is_always_due);
+    RUN_TEST(test_deadband_is_measured_from_last_published_value);
+    RUN_TEST(test_zero_deadband_publishes_any_change);
+    RUN_TEST(test_transition_to_zero_bypasses_deadband);
+    RUN_TEST(test_heartbeat_after_max_silence);
+    RUN_TEST(test_invalidate_forces_republish);
+    return UNITY_END();
+}
@@ -0,0 +1,79 @@
+#include <unity.h>
+
+#include <cmath>
+
+#include "SensorModeStats.h"
+
+namespace
+{
+    SensorModeStats stats;
+}
+
+void setUp()
+{
+    stats = SensorModeStats();
+}
+void tearDown() {}
+
+void test_mode_normalization()
+{
+    TEST_ASSERT_EQUAL_UINT8(9, SensorModeStats::normalizeBits(4));
+    TEST_ASSERT_EQUAL_UINT8(12, SensorModeStats::normalizeBits(16));
+    TEST_ASSERT_EQUAL_UINT8(1, SensorModeStats::normalizeOversample(0));
+    TEST_ASSERT_EQUAL_UINT8(2, SensorModeStats::normalizeOversample(3));
+    TEST_ASSERT_EQUAL_UINT8(4, SensorModeStats::normalizeOversample(7));
+    TEST_ASSERT_EQUAL_UINT8(8, SensorModeStats::normalizeOversample(100));
+    TEST_ASSERT_EQUAL_FLOAT(0.0625f, SensorModeStats::lsbC(12));
+}
+
+void test_linear_trend_is_not_noise()
+{
+    stats.select(12, 1);
+    for (int i = 0; i < 50; ++i)
+    {
+        stats.addSample(750, 40.0f + 0.125f * i); // steady heat-up, exact multiples of the LSB
+    }
+    const SensorModeStats::Entry &e = stats.current();
+    TEST_ASSERT_EQUAL_UINT32(50, e.samples);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 750.0f, e.sampleMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0625f / 3.4641f, e.noiseC); // quantisation floor only
+}
+
+void test_alternating_noise_is_measured()
+{
+    stats.select(10, 4);
+    for (int i = 0; i < 200; ++i)
+    {
+        stats.addSample(800, 50.0f + ((i & 1) ? 0.1f : -0.1f)); // d2 = +-0.4
+    }
+    const float expected = std::sqrt(0.16f / 6.0f + 0.25f * 0.25f / 12.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, expected, stats.stats(10, 4).noiseC);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.stats(10, 1).samples); // other modes untouched
+}
+
+void test_modes_are_kept_apart_and_faults_break_the_chain()
+{
+    stats.select(9, 1);
+    stats.addSample(100, 20.0f);
+    stats.addSample(100, 20.0f);
+    stats.select(12, 2);
+    stats.addSample(1500, 80.0f); // a jump after a mode switch must not count as noise
+    stats.addSample(1500, 80.0f);
+    stats.addFault();
+    stats.addSample(1500, 30.0f);
+    stats.addSample(1500, 30.0f);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.stats(9, 1).samples);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.stats(12, 2).samples);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0625f / 3.4641f, stats.stats(12, 2).noiseC);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 100.0f, stats.stats(9, 1).sampleMs);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_mode_normalization);
+    RUN_TEST(test_linear_trend_is_not_noise);
+    RUN_TEST(test_alternating_noise_is_measured);
+    RUN_TEST(test_modes_are_kept_apart_and_faults_break_the_chain);
+    return UNITY_END();
+}
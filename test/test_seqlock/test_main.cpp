@@ -0,0 +1,101 @@
+#include <unity.h>
+
+#include <atomic>
+#include <thread>
+
+#include "Seqlock.h"
+
+namespace
+{
+    struct State
+    {
+        uint32_t seq;
+        float temperature;
+        int32_t timeRemainingSec;
+        uint32_t check; // always ~seq, detects torn reads
+    };
+
+    State make(uint32_t i)
+    {
+        return {i, static_cast<float>(i) * 0.5f, static_cast<int32_t>(i), ~i};
+    }
+
+    bool isTorn(const State &s)
+    {
+        if (s.seq == 0)
+        {
+            return s.check != 0 || s.timeRemainingSec != 0; // default value before the first store
+        }
+        return s.check != ~s.seq || s.timeRemainingSec != static_cast<int32_t>(s.seq);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_load_returns_default_then_latest_store()
+{
+    Seqlock<State> lock;
+    TEST_ASSERT_EQUAL_UINT32(0, lock.load(make(99)).seq);
+    TEST_ASSERT_EQUAL_UINT32(0, lock.version());
+
+    lock.store(make(7));
+    lock.store(make(8));
+    const State s = lock.load(State{});
+    TEST_ASSERT_EQUAL_UINT32(8, s.seq);
+    TEST_ASSERT_EQUAL_INT32(8, s.timeRemainingSec);
+    TEST_ASSERT_EQUAL_UINT32(2, lock.version());
+}
+
+void test_concurrent_readers_never_see_torn_values()
+{
+    Seqlock<State> lock;
+    std::atomic<bool> done{false};
+    constexpr uint32_t COUNT = 200000;
+
+    std::thread writer([&]()
+                       {
+        for (uint32_t i = 1; i <= COUNT; ++i)
+        {
+            lock.store(make(i));
+        }
+        done = true; });
+
+    uint32_t torn[2] = {};
+    uint32_t backwards[2] = {};
+    std::thread second([&]()
+                       {
+        uint32_t last = 0;
+        State s = {};
+        while (!done)
+        {
+            s = lock.load(s);
+            torn[1] += isTorn(s) ? 1 : 0;
+            backwards[1] += s.seq < last ? 1 : 0;
+            last = s.seq;
+        } });
+
+    uint32_t last = 0;
+    State s = {};
+    while (!done)
+    {
+        s = lock.load(s);
+        torn[0] += isTorn(s) ? 1 : 0;
+        backwards[0] += s.seq < last ? 1 : 0;
+        last = s.seq;
+    }
+    writer.join();
+    second.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn[0] + torn[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards[0] + backwards[1]);
+    TEST_ASSERT_EQUAL_UINT32(COUNT, lock.load(State{}).seq);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_load_returns_default_then_latest_store);
+    RUN_TEST(test_concurrent_readers_never_see_torn_values);
+    return UNITY_END();
+}
@@ -0,0 +1,263 @@
+#include <unity.h>
+
+#include <map>
+#include <vector>
+
+#include "SessionLog.h"
+
+namespace
+{
+    // [MOCKED!] In-memory segment files.
+    class FakeSessionStorage : public SessionLogStorage
+    {
+    public:
+        uint8_t listSegments(uint32_t *ids, uint8_t maxIds) override
+        {
+            uint8_t n = 0;
+            for (auto it = files.rbegin(); it != files.rend() && n < maxIds; ++it)
+            {
+                ids[n++] = it->first; // reverse order: the log must not rely on listing order
+            }
+            return n;
+        }
+        size_t segmentSize(uint32_t id) override { return files.count(id) ? files[id].size() : 0; }
+        bool append(uint32_t id, const uint8_t *data, size_t len) override
+        {
+            if (failWrites)
+            {
+                return false;
+            }
+            appendCalls++;
+            files[id].insert(files[id].end(), data, data + len);
+            return true;
+        }
+        bool read(uint32_t id, size_t offset, uint8_t *data, size_t len) override
+        {
+            readCalls++;
+            if (!files.count(id) || offset + len > files[id].size())
+            {
+                return false;
+            }
+            std::copy(files[id].begin() + offset, files[id].begin() + offset + len, data);
+            return true;
+        }
+        bool remove(uint32_t id) override { return files.erase(id) > 0; }
+
+        std::map<uint32_t, std::vector<uint8_t>> files;
+        bool failWrites = false;
+        int appendCalls = 0;
+        int readCalls = 0;
+    };
+
+    FakeSessionStorage storage;
+    constexpr uint32_t T0 = 1700000000UL;
+
+    SessionRecord makeRecord(uint32_t i)
+    {
+        SessionRecord r;
+        r.startTime = T0 + i * 3600;
+        r.endTime = r.startTime + 1800;
+        r.onMinutes = static_cast<uint16_t>(20 + i % 10);
+        r.heatMinutes = static_cast<uint16_t>(15 + i % 10);
+        r.startTemp = 45.5f + (i % 7);
+        r.endTemp = 78.25f;
+        r.reason = static_cast<uint8_t>(i % 5);
+        return r;
+    }
+}
+
+void setUp()
+{
+    storage = FakeSessionStorage();
+}
+void tearDown() {}
+
+void test_records_roundtrip_and_detect_corruption()
+{
+    uint8_t buf[SessionLog::RECORD_BYTES];
+    SessionRecord in = makeRecord(3);
+    in.startTemp = -5.3f;
+    SessionLog::encode(in, buf);
+
+    SessionRecord out;
+    TEST_ASSERT_TRUE(SessionLog::decode(buf, out));
+    TEST_ASSERT_EQUAL_UINT32(in.startTime, out.startTime);
+    TEST_ASSERT_EQUAL_UINT32(in.endTime, out.endTime);
+    TEST_ASSERT_EQUAL_UINT16(in.onMinutes, out.onMinutes);
+    TEST_ASSERT_EQUAL_UINT16(in.heatMinutes, out.heatMinutes);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f / 32, -5.3f, out.startTemp);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f / 32, 78.25f, out.endTemp);
+    TEST_ASSERT_EQUAL_UINT8(in.reason, out.reason);
+
+    buf[5] ^= 0x10;
+    TEST_ASSERT_FALSE(SessionLog::decode(buf, out));
+}
+
+void test_writes_are_batched_into_pages()
+{
+    SessionLog log(storage);
+    TEST_ASSERT_EQUAL_UINT32(0, log.begin());
+
+    for (uint32_t i = 0; i < SessionLog::RECORDS_PER_PAGE - 1; ++i)
+    {
+        TEST_ASSERT_TRUE(log.append(makeRecord(i), 0));
+    }
+    TEST_ASSERT_EQUAL_INT(0, storage.appendCalls);
+    TEST_ASSERT_EQUAL_UINT32(SessionLog::RECORDS_PER_PAGE - 1, log.size());
+
+    SessionRecord r;
+    TEST_ASSERT_TRUE(log.read(4, r)); // buffered records are readable
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(4).startTime, r.startTime);
+
+    TEST_ASSERT_TRUE(log.append(makeRecord(15), 0));
+    TEST_ASSERT_EQUAL_INT(1, storage.appendCalls);
+    TEST_ASSERT_EQUAL_UINT(SessionLog::PAGE_BYTES, storage.files[1].size());
+    TEST_ASSERT_EQUAL_UINT8(0, log.pendingCount());
+}
+
+void test_partial_page_flushes_after_hold_time()
+{
+    SessionLog log(storage);
+    log.begin();
+    log.append(makeRecord(0), 1000);
+    log.append(makeRecord(1), 50000);
+
+    TEST_ASSERT_TRUE(log.flushDue(60000, 60000));
+    TEST_ASSERT_EQUAL_INT(0, storage.appendCalls); // oldest waited 59 s
+    TEST_ASSERT_TRUE(log.flushDue(61000, 60000));
+    TEST_ASSERT_EQUAL_INT(1, storage.appendCalls);
+    TEST_ASSERT_EQUAL_UINT(2 * SessionLog::RECORD_BYTES, storage.files[1].size());
+
+    log.append(makeRecord(2), 70000);
+    TEST_ASSERT_TRUE(log.flush());
+    TEST_ASSERT_EQUAL_UINT(3 * SessionLog::RECORD_BYTES, storage.files[1].size());
+}
+
+void test_boot_indexes_without_reading_records()
+{
+    {
+        SessionLog log(storage);
+        log.begin();
+        for (uint32_t i = 0; i < 2500; ++i)
+        {
+            log.append(makeRecord(i), 0);
+        }
+        log.flush();
+    }
+
+    storage.readCalls = 0;
+    SessionLog log(storage);
+    TEST_ASSERT_EQUAL_UINT32(2500, log.begin());
+    TEST_ASSERT_EQUAL_INT(0, storage.readCalls);
+    TEST_ASSERT_EQUAL_UINT8(3, log.segmentCount());
+
+    SessionRecord r;
+    TEST_ASSERT_TRUE(log.read(0, r));
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(0).startTime, r.startTime);
+    TEST_ASSERT_TRUE(log.read(2499, r));
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(2499).startTime, r.startTime);
+    TEST_ASSERT_FALSE(log.read(2500, r));
+
+    // Appends continue in the newest segment
+    log.append(makeRecord(2500), 0);
+    log.flush();
+    TEST_ASSERT_EQUAL_UINT32(2501, log.size());
+    TEST_ASSERT_TRUE(log.read(2500, r));
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(2500).startTime, r.startTime);
+}
+
+void test_oldest_segment_is_dropped_when_full()
+{
+    SessionLog log(storage);
+    log.begin();
+    const uint32_t total = SessionLog::SEGMENT_RECORDS * SessionLog::MAX_SEGMENTS + 10;
+    for (uint32_t i = 0; i < total; ++i)
+    {
+        log.append(makeRecord(i), 0);
+    }
+    log.flush();
+
+    TEST_ASSERT_EQUAL_UINT8(SessionLog::MAX_SEGMENTS, log.segmentCount());
+    TEST_ASSERT_EQUAL_UINT(SessionLog::MAX_SEGMENTS, storage.files.size());
+    TEST_ASSERT_EQUAL_UINT32(SessionLog::SEGMENT_RECORDS * (SessionLog::MAX_SEGMENTS - 1) + 10, log.size());
+
+    SessionRecord r;
+    TEST_ASSERT_TRUE(log.read(0, r));
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(SessionLog::SEGMENT_RECORDS).startTime, r.startTime);
+    TEST_ASSERT_TRUE(log.read(log.size() - 1, r));
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(total - 1).startTime, r.startTime);
+}
+
+void test_torn_tail_and_write_errors_keep_records()
+{
+    SessionLog log(storage);
+    log.begin();
+    log.append(makeRecord(0), 0);
+    log.flush();
+    storage.files[1].push_back(0xAB); // interrupted write
+
+    SessionLog reopened(storage);
+    TEST_ASSERT_EQUAL_UINT32(1, reopened.begin());
+    storage.failWrites = true;
+    reopened.append(makeRecord(1), 0);
+    TEST_ASSERT_FALSE(reopened.flush());
+    TEST_ASSERT_EQUAL_UINT8(1, reopened.pendingCount());
+    TEST_ASSERT_EQUAL_UINT32(1, reopened.writeErrors());
+
+    storage.failWrites = false;
+    TEST_ASSERT_TRUE(reopened.flush());
+    TEST_ASSERT_EQUAL_UINT(2, storage.files.size()); // continued in a fresh segment
+    SessionRecord r;
+    TEST_ASSERT_TRUE(reopened.read(1, r));
+    TEST_ASSERT_EQUAL_UINT32(makeRecord(1).startTime, r.startTime);
+}
+
+void test_tracker_builds_session_records()
+{
+    SessionTracker tracker;
+    SessionRecord rec;
+    uint32_t now = 10000;
+    TEST_ASSERT_FALSE(tracker.update(now, T0, false, false, 50.0f, 78.0f, 0, rec));
+    TEST_ASSERT_FALSE(tracker.open());
+
+    TEST_ASSERT_FALSE(tracker.update(now, T0, true, true, 50.0f, 78.0f, 0, rec));
+    TEST_ASSERT_TRUE(tracker.open());
+    now += 20 * 60000UL; // 20 min heating
+    TEST_ASSERT_FALSE(tracker.update(now, T0 + 1200, false, true, 78.0f, 78.0f, 1, rec));
+    now += 10 * 60000UL; // 10 min waiting with the timer running
+    TEST_ASSERT_FALSE(tracker.update(now, T0 + 1800, true, true, 76.0f, 78.0f, 1, rec));
+    now += 5 * 60000UL;
+    TEST_ASSERT_TRUE(tracker.update(now, T0 + 2100, false, false, 78.5f, 78.0f, 3, rec));
+
+    TEST_ASSERT_FALSE(tracker.open());
+    TEST_ASSERT_EQUAL_UINT32(T0, rec.startTime);
+    TEST_ASSERT_EQUAL_UINT32(T0 + 2100, rec.endTime);
+    TEST_ASSERT_EQUAL_UINT16(25, rec.onMinutes);
+    TEST_ASSERT_EQUAL_UINT16(20, rec.heatMinutes); // 78 °C first seen after 20 min
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, rec.startTemp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 78.5f, rec.endTemp);
+    TEST_ASSERT_EQUAL_UINT8(3, rec.reason);
+
+    // Target never reached
+    tracker.update(now, T0 + 3000, true, true, 50.0f, 78.0f, 0, rec);
+    TEST_ASSERT_TRUE(tracker.update(now + 60000, T0 + 3060, false, false, 52.0f, 78.0f, 4, rec));
+    TEST_ASSERT_EQUAL_UINT16(SessionRecord::HEAT_UNKNOWN, rec.heatMinutes);
+
+    // Without a synced clock the session is dropped
+    tracker.update(now, 0, true, true, 50.0f, 78.0f, 0, rec);
+    TEST_ASSERT_FALSE(tracker.update(now + 1000, 0, false, false, 51.0f, 78.0f, 2, rec));
+    TEST_ASSERT_FALSE(tracker.open());
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_records_roundtrip_and_detect_corruption);
+    RUN_TEST(test_writes_are_batched_into_pages);
+    RUN_TEST(test_partial_page_flushes_after_hold_time);
+    RUN_TEST(test_boot_indexes_without_reading_records);
+    RUN_TEST(test_oldest_segment_is_dropped_when_full);
+    RUN_TEST(test_torn_tail_and_write_errors_keep_records);
+    RUN_TEST(test_tracker_builds_session_records);
+    return UNITY_END();
+}
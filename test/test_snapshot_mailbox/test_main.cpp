@@ -0,0 +1,114 @@
+#include <unity.h>
+
+#include <atomic>
+#include <thread>
+
+#include "SnapshotMailbox.h"
+
+namespace
+{
+    struct Snapshot
+    {
+        uint32_t seq;
+        uint32_t check; // must always be ~seq, detects torn reads
+        float temperature;
+    };
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_take_returns_false_until_published()
+{
+    SnapshotMailbox<Snapshot> box;
+    Snapshot s = {};
+    TEST_ASSERT_FALSE(box.hasNew());
+    TEST_ASSERT_FALSE(box.take(s));
+
+    box.publish({1, ~1U, 55.5f});
+    TEST_ASSERT_TRUE(box.hasNew());
+    TEST_ASSERT_TRUE(box.take(s));
+    TEST_ASSERT_EQUAL_UINT32(1, s.seq);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 55.5f, s.temperature);
+    TEST_ASSERT_FALSE(box.take(s));
+}
+
+void test_consumer_gets_latest_and_skips_stale()
+{
+    SnapshotMailbox<Snapshot> box;
+    for (uint32_t i = 1; i <= 5; ++i)
+    {
+        box.publish({i, ~i, 0.0f});
+    }
+    Snapshot s = {};
+    TEST_ASSERT_TRUE(box.take(s));
+    TEST_ASSERT_EQUAL_UINT32(5, s.seq);
+    TEST_ASSERT_FALSE(box.take(s));
+    TEST_ASSERT_EQUAL_UINT32(5, box.publishedCount());
+    TEST_ASSERT_EQUAL_UINT32(1, box.takenCount());
+}
+
+void test_interleaved_publish_and_take()
+{
+    SnapshotMailbox<Snapshot> box;
+    Snapshot s = {};
+    for (uint32_t i = 1; i <= 100; ++i)
+    {
+        box.publish({i, ~i, 0.0f});
+        if (i % 3 == 0)
+        {
+            TEST_ASSERT_TRUE(box.take(s));
+            TEST_ASSERT_EQUAL_UINT32(i, s.seq);
+        }
+    }
+}
+
+void test_concurrent_reader_never_sees_torn_or_old_snapshots()
+{
+    SnapshotMailbox<Snapshot> box;
+    std::atomic<bool> done{false};
+    constexpr uint32_t COUNT = 200000;
+
+    std::thread producer([&]()
+                         {
+        for (uint32_t i = 1; i <= COUNT; ++i)
+        {
+            box.publish({i, ~i, static_cast<float>(i)});
+        }
+        done = true; });
+
+    uint32_t lastSeq = 0;
+    uint32_t torn = 0;
+    uint32_t backwards = 0;
+    Snapshot s = {};
+    while (!done || box.hasNew())
+    {
+        if (box.take(s))
+        {
+            if (s.check != ~s.seq)
+            {
+                torn++;
+            }
+            if (s.seq <= lastSeq)
+            {
+                backwards++;
+            }
+            lastSeq = s.seq;
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards);
+    TEST_ASSERT_EQUAL_UINT32(COUNT, lastSeq);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_take_returns_false_until_published);
+    RUN_TEST(test_consumer_gets_latest_and_skips_stale);
+    RUN_TEST(test_interleaved_publish_and_take);
+    RUN_TEST(test_concurrent_reader_never_sees_torn_or_old_snapshots);
+    return UNITY_END();
+}
@@ -0,0 +1,127 @@
+#include <unity.h>
+
+#include "TankModel.h"
+#include "../fakes/BoilerFakes.h"
+
+namespace
+{
+    constexpr uint32_t SAMPLE_MS = 10000; // sensor read interval
+
+    // Feed the model from the fake tank for the given time with a fixed relay state.
+    void run(TankModel &model, FakeTank &tank, uint32_t &nowMs, bool relayOn, uint32_t durationMs)
+    {
+        for (uint32_t t = 0; t < durationMs; t += SAMPLE_MS)
+        {
+            tank.step(relayOn, SAMPLE_MS / 1000.0f);
+            nowMs += SAMPLE_MS;
+            model.addSample(nowMs, tank.temperature, relayOn);
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_unknown_until_enough_windows()
+{
+    TankModel model;
+    TEST_ASSERT_FALSE(model.heatingKnown());
+    TEST_ASSERT_EQUAL_INT32(-1, model.secondsToTarget(50.0f, 78.0f));
+    TEST_ASSERT_EQUAL_INT32(0, model.secondsToTarget(80.0f, 78.0f));
+    TEST_ASSERT_EQUAL_INT32(-1, model.secondsUntilBelow(70.0f, 60.0f));
+}
+
+void test_learns_heating_rate_and_predicts_time()
+{
+    TankModel model;
+    FakeTank tank;
+    tank.lossPerSec = 0.0f;
+    uint32_t now = 0;
+    model.addSample(now, tank.temperature, true);
+    run(model, tank, now, true, 10UL * 60000);
+
+    TEST_ASSERT_TRUE(model.heatingKnown());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.6f, model.heatingRate()); // 0.01 K/s
+    const int32_t eta = model.secondsToTarget(60.0f, 66.0f);
+    TEST_ASSERT_INT32_WITHIN(15, 600, eta);
+}
+
+void test_learns_cooling_rate()
+{
+    TankModel model;
+    FakeTank tank;
+    tank.temperature = 70.0f;
+    tank.lossPerSec = 0.0001f;
+    uint32_t now = 0;
+    model.addSample(now, tank.temperature, false);
+    run(model, tank, now, false, 20UL * 60000);
+
+    TEST_ASSERT_TRUE(model.coolingKnown());
+    TEST_ASSERT_TRUE(model.coolingRate() < 0.0f);
+    // (70 - 18) * 0.0001 * 60 ~= 0.31 K/min at the start, slightly less later
+    TEST_ASSERT_FLOAT_WITHIN(0.03f, -0.3f, model.coolingRate());
+    TEST_ASSERT_TRUE(model.secondsUntilBelow(tank.temperature, 60.0f) > 0);
+}
+
+void test_settle_time_after_switch_is_ignored()
+{
+    TankModel model;
+    uint32_t now = 0;
+    float temp = 50.0f;
+    model.addSample(now, temp, true);
+    // Burner lag: flat for the settle period, then 1 K/min
+    for (uint32_t t = 0; t < TankModel::SETTLE_MS; t += SAMPLE_MS)
+    {
+        now += SAMPLE_MS;
+        model.addSample(now, temp, true);
+    }
+    for (int i = 0; i < 30; ++i)
+    {
+        now += SAMPLE_MS;
+        temp += 1.0f / 6.0f;
+        model.addSample(now, temp, true);
+    }
+    TEST_ASSERT_TRUE(model.heatingKnown());
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1.0f, model.heatingRate());
+}
+
+void test_learns_overshoot_after_heating_run()
+{
+    TankModel model;
+    uint32_t now = 0;
+    model.addSample(now, 70.0f, true);
+    now += SAMPLE_MS;
+    model.addSample(now, 76.0f, false); // relay off at 76
+    const float rise[] = {76.4f, 76.9f, 77.2f, 77.3f, 77.1f, 76.6f};
+    for (float t : rise)
+    {
+        now += SAMPLE_MS;
+        model.addSample(now, t, false);
+    }
+    TEST_ASSERT_TRUE(model.overshootKnown());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.3f, model.overshootC());
+}
+
+void test_long_gap_restarts_window()
+{
+    TankModel model;
+    model.addSample(0, 50.0f, true);
+    model.addSample(TankModel::SETTLE_MS + 60000, 52.0f, true); // first window
+    const uint32_t resumed = TankModel::SETTLE_MS + 60000 + TankModel::MAX_GAP_MS + 1;
+    model.addSample(resumed, 90.0f, true);         // gap: restart, the 38 K jump is not a rate
+    model.addSample(resumed + 60000, 90.5f, true); // still settling after the restart
+    TEST_ASSERT_FALSE(model.heatingKnown());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f / 3.0f, model.heatingRate());
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_unknown_until_enough_windows);
+    RUN_TEST(test_learns_heating_rate_and_predicts_time);
+    RUN_TEST(test_learns_cooling_rate);
+    RUN_TEST(test_settle_time_after_switch_is_ignored);
+    RUN_TEST(test_learns_overshoot_after_heating_run);
+    RUN_TEST(test_long_gap_restarts_window);
+    return UNITY_END();
+}
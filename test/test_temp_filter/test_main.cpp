@@ -0,0 +1,91 @@
+#include <unity.h>
+
+#include "TempFilter.h"
+
+namespace
+{
+    TempFilter filter;
+
+    TempFilter::Config makeConfig(uint8_t medianN, float alpha, float rate)
+    {
+        TempFilter::Config c;
+        c.medianN = medianN;
+        c.emaAlpha = alpha;
+        c.maxRatePerMin = rate;
+        return c;
+    }
+}
+
+void setUp()
+{
+    filter = TempFilter();
+}
+void tearDown() {}
+
+void test_all_stages_off_passes_raw()
+{
+    filter.configure(makeConfig(1, 1.0f, 0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(50.0f, filter.apply(50.0f, 0));
+    TEST_ASSERT_EQUAL_FLOAT(80.0f, filter.apply(80.0f, 1000));
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, filter.apply(20.0f, 2000));
+}
+
+void test_median_rejects_single_spike()
+{
+    filter.configure(makeConfig(5, 1.0f, 0.0f));
+    uint32_t t = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        filter.apply(60.0f + 0.1f * i, t += 1000);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.25f, 60.2f, filter.apply(85.0f, t += 1000)); // spike
+    TEST_ASSERT_FLOAT_WITHIN(0.25f, 60.3f, filter.apply(-20.0f, t += 1000)); // dropout
+    TEST_ASSERT_FLOAT_WITHIN(0.25f, 60.4f, filter.apply(60.5f, t += 1000));
+}
+
+void test_even_window_is_rounded_up_and_clamped()
+{
+    filter.configure(makeConfig(4, 1.0f, 0.0f));
+    TEST_ASSERT_EQUAL_UINT8(5, filter.config().medianN);
+    filter.configure(makeConfig(20, 1.0f, 0.0f));
+    TEST_ASSERT_EQUAL_UINT8(TempFilter::MAX_MEDIAN, filter.config().medianN);
+}
+
+void test_ema_smooths_step()
+{
+    filter.configure(makeConfig(1, 0.5f, 0.0f));
+    filter.apply(40.0f, 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, filter.apply(60.0f, 1000));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 55.0f, filter.apply(60.0f, 2000));
+}
+
+void test_rate_limiter_clamps_slope_and_counts()
+{
+    filter.configure(makeConfig(1, 1.0f, 6.0f)); // 0.1 °C per second
+    filter.apply(50.0f, 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.1f, filter.apply(60.0f, 1000));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 49.9f, filter.apply(40.0f, 3000));
+    TEST_ASSERT_EQUAL_UINT32(2, filter.limitedCount());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 49.95f, filter.apply(49.95f, 4000)); // within the limit
+}
+
+void test_reset_restarts_series()
+{
+    filter.configure(makeConfig(3, 0.2f, 1.0f));
+    filter.apply(30.0f, 0);
+    filter.reset();
+    TEST_ASSERT_FALSE(filter.primed());
+    TEST_ASSERT_EQUAL_FLOAT(70.0f, filter.apply(70.0f, 1000)); // first sample after reset passes as is
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_all_stages_off_passes_raw);
+    RUN_TEST(test_median_rejects_single_spike);
+    RUN_TEST(test_even_window_is_rounded_up_and_clamped);
+    RUN_TEST(test_ema_smooths_step);
+    RUN_TEST(test_rate_limiter_clamps_slope_and_counts);
+    RUN_TEST(test_reset_restarts_series);
+    return UNITY_END();
+}
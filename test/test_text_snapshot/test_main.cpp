@@ -0,0 +1,109 @@
+#include <unity.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#include "TextSnapshot.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_until_first_commit()
+{
+    TextSnapshot<32> snap;
+    char out[32] = "x";
+    TEST_ASSERT_EQUAL_UINT32(0, snap.version());
+    TEST_ASSERT_EQUAL(0, snap.read(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("", out);
+
+    snap.set("0:12:30");
+    TEST_ASSERT_EQUAL_UINT32(1, snap.version());
+    TEST_ASSERT_EQUAL(7, snap.read(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("0:12:30", out);
+}
+
+void test_latest_commit_wins_and_truncates()
+{
+    TextSnapshot<8> snap;
+    snap.set("first");
+    snap.set("second");
+    snap.set("much too long");
+    char out[16];
+    TEST_ASSERT_EQUAL(7, snap.read(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("much to", out);
+
+    char small[4];
+    TEST_ASSERT_EQUAL(3, snap.read(small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("muc", small);
+}
+
+void test_begin_write_commit()
+{
+    TextSnapshot<64> snap;
+    char *buf = snap.beginWrite();
+    const int len = snprintf(buf, TextSnapshot<64>::CAPACITY, "{\"temp\":%.1f}", 55.5);
+    snap.commit(static_cast<size_t>(len));
+    char out[64];
+    snap.read(out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":55.5}", out);
+}
+
+void test_concurrent_readers_never_see_torn_text()
+{
+    TextSnapshot<48> snap;
+    std::atomic<bool> done{false};
+    constexpr uint32_t COUNT = 100000;
+
+    std::thread writer([&]()
+                       {
+        for (uint32_t i = 1; i <= COUNT; ++i)
+        {
+            char *buf = snap.beginWrite();
+            const int len = snprintf(buf, TextSnapshot<48>::CAPACITY, "{\"a\":%lu,\"b\":%lu}", (unsigned long)i, (unsigned long)i);
+            snap.commit(static_cast<size_t>(len));
+        }
+        done = true; });
+
+    uint32_t torn = 0;
+    uint32_t backwards = 0;
+    uint32_t reads = 0;
+    unsigned long last = 0;
+    while (!done)
+    {
+        char out[48];
+        if (snap.read(out, sizeof(out)) == 0)
+        {
+            continue;
+        }
+        unsigned long a = 0, b = 0;
+        if (sscanf(out, "{\"a\":%lu,\"b\":%lu}", &a, &b) != 2 || a != b)
+        {
+            torn++;
+        }
+        if (a < last)
+        {
+            backwards++;
+        }
+        last = a;
+        reads++;
+    }
+    writer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards);
+    TEST_ASSERT_TRUE(reads > 0);
+    char out[48];
+    snap.read(out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("{\"a\":100000,\"b\":100000}", out);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_until_first_commit);
+    RUN_TEST(test_latest_commit_wins_and_truncates);
+    RUN_TEST(test_begin_write_commit);
+    RUN_TEST(test_concurrent_readers_never_see_torn_text);
+    return UNITY_END();
+}